@@ -0,0 +1,178 @@
+#include <whaleroute/requestrouter.h>
+#include <benchmark/benchmark.h>
+#include <optional>
+#include <string>
+
+namespace {
+
+enum class RequestMethod {
+    GET,
+    POST
+};
+
+struct Request {
+    RequestMethod method;
+    std::string path;
+};
+
+struct Response {
+    void send(const std::string& value)
+    {
+        data = value;
+        wasSent = true;
+    }
+
+    std::string data;
+    bool wasSent = false;
+};
+
+struct PageId {
+    int value;
+};
+
+} // namespace
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestMethod> {
+    bool operator()(RequestMethod value, const Request& request) const
+    {
+        return value == request.method;
+    }
+};
+
+template<>
+struct StringConverter<PageId> {
+    static std::optional<PageId> fromString(const std::string& data)
+    {
+        if (data.empty() || data.size() > 9 || data.find_first_not_of("0123456789") != std::string::npos)
+            return std::nullopt;
+        return PageId{std::stoi(data)};
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class Router : public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.path;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.wasSent;
+    }
+};
+
+std::string routePath(std::int64_t routeIndex)
+{
+    return "/route/" + std::to_string(routeIndex);
+}
+
+template<typename TRouter>
+void processRequests(benchmark::State& state, TRouter& router, const Request& request)
+{
+    for (auto _ : state) {
+        auto response = Response{};
+        router.process(request, response);
+        benchmark::DoNotOptimize(response.data);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void literalRoutes(benchmark::State& state)
+{
+    auto router = Router{};
+    for (auto i = std::int64_t{}; i < state.range(0); ++i)
+        router.route(routePath(i)).set("OK");
+
+    processRequests(state, router, Request{RequestMethod::GET, routePath(state.range(0) - 1)});
+}
+
+void regexRoutes(benchmark::State& state)
+{
+    auto router = Router{};
+    for (auto i = std::int64_t{}; i < state.range(0); ++i)
+        router.route(whaleroute::rx{routePath(i) + R"(/\d+)"}).set("OK");
+
+    processRequests(state, router, Request{RequestMethod::GET, routePath(state.range(0) - 1) + "/42"});
+}
+
+void routeMatchers(benchmark::State& state)
+{
+    auto router = Router{};
+    for (auto i = std::int64_t{}; i < state.range(0); ++i) {
+        router.route(routePath(i), RequestMethod::POST).set("POST");
+        router.route(routePath(i), RequestMethod::GET).set("GET");
+    }
+
+    processRequests(state, router, Request{RequestMethod::GET, routePath(state.range(0) - 1)});
+}
+
+void routeParameterConversion(benchmark::State& state)
+{
+    auto router = Router{};
+    for (auto i = std::int64_t{}; i < state.range(0) - 1; ++i)
+        router.route(routePath(i)).set("OK");
+    router.route(whaleroute::rx{R"(/page/(\d+)/(\d+)/(\w+))"})
+            .process(
+                    [](int chapter, PageId pageId, const std::string& section, const Request&)
+                    {
+                        return std::to_string(chapter + pageId.value) + section;
+                    });
+
+    processRequests(state, router, Request{RequestMethod::GET, "/page/12/345/intro"});
+}
+
+void queueCreation(benchmark::State& state)
+{
+    auto router = Router{};
+    for (auto i = std::int64_t{}; i < state.range(0); ++i)
+        router.route(routePath(i)).set("OK");
+
+    const auto request = Request{RequestMethod::GET, routePath(state.range(0) - 1)};
+    for (auto _ : state) {
+        auto response = Response{};
+        auto queue = router.makeRequestProcessorQueue(request, response);
+        benchmark::DoNotOptimize(queue);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void multipleMatchedRoutes(benchmark::State& state)
+{
+    auto router = Router{};
+    for (auto i = std::int64_t{}; i < state.range(0) - 1; ++i)
+        router.route("/chain")
+                .process(
+                        [](const Request&, Response& response)
+                        {
+                            benchmark::DoNotOptimize(response.data);
+                        });
+    router.route("/chain").set("OK");
+
+    processRequests(state, router, Request{RequestMethod::GET, "/chain"});
+}
+
+} // namespace
+
+BENCHMARK(literalRoutes)->RangeMultiplier(10)->Range(10, 100'000);
+BENCHMARK(regexRoutes)->RangeMultiplier(10)->Range(10, 100'000);
+BENCHMARK(routeMatchers)->RangeMultiplier(10)->Range(10, 100'000);
+BENCHMARK(routeParameterConversion)->RangeMultiplier(10)->Range(10, 100'000);
+BENCHMARK(queueCreation)->RangeMultiplier(10)->Range(10, 100'000);
+BENCHMARK(multipleMatchedRoutes)->RangeMultiplier(10)->Range(10, 100'000);
@@ -0,0 +1,83 @@
+#ifndef WHALEROUTE_FROZENREQUESTROUTER_H
+#define WHALEROUTE_FROZENREQUESTROUTER_H
+
+#include "requestprocessorqueue.h"
+#include "routetable.h"
+#include "types.h"
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace whaleroute {
+template<typename TRequest, typename TResponse, typename TResponseConverter, typename TRouteContext>
+class RequestRouter;
+template<typename TRequest, typename TResponse, typename TResponseConverter, typename TRouteContext>
+class RequestRouterHandle;
+
+/// Immutable router created by RequestRouter::freeze().
+/// Its methods are safe to call from any number of threads concurrently, as long as the registered
+/// request processors, route matchers and the overridden methods of RequestRouter are safe to call concurrently too.
+template<typename TRequest, typename TResponse, typename TResponseConverter = _, typename TRouteContext = _>
+class FrozenRequestRouter {
+    using Router = RequestRouter<TRequest, TResponse, TResponseConverter, TRouteContext>;
+    using RouteTable = detail::RouteTable<TRequest, TResponse, TRouteContext>;
+    friend Router;
+
+    FrozenRequestRouter(Router& router, std::shared_ptr<const RouteTable> routeTable)
+        : router_{&router}
+        , routeTable_{std::move(routeTable)}
+    {
+    }
+
+public:
+    void process(const TRequest& request, TResponse& response) const
+    {
+        auto queue = makeRequestProcessorQueue(request, response);
+        queue.launch();
+    }
+
+    RequestProcessorQueue makeRequestProcessorQueue(const TRequest& request, TResponse& response) const
+    {
+        return router_->makeRequestProcessorQueue(*routeTable_, request, response, {}, routeTable_);
+    }
+
+    template<typename TExecutor, std::enable_if_t<detail::IsExecutor<TExecutor>::value>* = nullptr>
+    void process(const TRequest& request, TResponse& response, TExecutor& executor) const
+    {
+        auto queue = makeRequestProcessorQueue(request, response, executor);
+        queue.launch();
+    }
+
+    template<typename TExecutor, std::enable_if_t<detail::IsExecutor<TExecutor>::value>* = nullptr>
+    RequestProcessorQueue makeRequestProcessorQueue(const TRequest& request, TResponse& response, TExecutor& executor)
+            const
+    {
+        return router_->makeRequestProcessorQueue(
+                *routeTable_,
+                request,
+                response,
+                detail::makeExecutor(executor),
+                routeTable_);
+    }
+
+    void process(const std::vector<TRequest>& requests, std::vector<TResponse>& responses) const
+    {
+        for (auto& queue : makeRequestProcessorQueues(requests, responses))
+            queue.launch();
+    }
+
+    std::vector<RequestProcessorQueue> makeRequestProcessorQueues(
+            const std::vector<TRequest>& requests,
+            std::vector<TResponse>& responses) const
+    {
+        return router_->makeRequestProcessorQueues(*routeTable_, requests, responses, routeTable_);
+    }
+
+private:
+    Router* router_;
+    std::shared_ptr<const RouteTable> routeTable_;
+};
+
+} // namespace whaleroute
+
+#endif // WHALEROUTE_FROZENREQUESTROUTER_H
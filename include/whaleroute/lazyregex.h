@@ -0,0 +1,55 @@
+#ifndef WHALEROUTE_LAZYREGEX_H
+#define WHALEROUTE_LAZYREGEX_H
+
+#include <atomic>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <utility>
+
+namespace whaleroute::detail {
+
+/// Regular expression compiled on the first use, which can happen concurrently from multiple threads.
+/// If the pattern is invalid, std::regex_error is thrown on each use.
+class LazyRegex {
+public:
+    explicit LazyRegex(std::string pattern)
+        : pattern_{std::move(pattern)}
+    {
+    }
+
+    LazyRegex(const LazyRegex&) = delete;
+    LazyRegex& operator=(const LazyRegex&) = delete;
+
+    const std::string& pattern() const
+    {
+        return pattern_;
+    }
+
+    bool isCompiled() const
+    {
+        return isCompiled_.load(std::memory_order_acquire);
+    }
+
+    const std::regex& get() const
+    {
+        if (!isCompiled()) {
+            auto lock = std::lock_guard{compileMutex_};
+            if (!isCompiled_.load(std::memory_order_relaxed)) {
+                regex_ = std::regex{pattern_};
+                isCompiled_.store(true, std::memory_order_release);
+            }
+        }
+        return regex_;
+    }
+
+private:
+    std::string pattern_;
+    mutable std::regex regex_;
+    mutable std::mutex compileMutex_;
+    mutable std::atomic<bool> isCompiled_ = false;
+};
+
+} // namespace whaleroute::detail
+
+#endif // WHALEROUTE_LAZYREGEX_H
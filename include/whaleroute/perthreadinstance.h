@@ -0,0 +1,68 @@
+#ifndef WHALEROUTE_PERTHREADINSTANCE_H
+#define WHALEROUTE_PERTHREADINSTANCE_H
+
+#include "utils.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace whaleroute::detail {
+
+/// Lazily creates a separate object for each thread that calls get().
+/// Objects are aligned to the cache line size to avoid false sharing and are destroyed together with PerThreadInstance.
+template<typename T>
+class PerThreadInstance {
+public:
+    struct alignas(cacheLineSize) Instance {
+        template<typename... TArgs>
+        explicit Instance(TArgs&&... args)
+            : value(std::forward<TArgs>(args)...)
+        {
+        }
+        T value;
+    };
+
+    explicit PerThreadInstance(std::function<std::unique_ptr<Instance>()> instanceFactory)
+        : instanceFactory_{std::move(instanceFactory)}
+        , id_{nextId()}
+    {
+    }
+
+    T& get()
+    {
+        // PerThreadInstance ids are never reused, so the cache can't return an object of a destroyed PerThreadInstance
+        thread_local auto instanceCache = std::unordered_map<std::uint64_t, T*>{};
+        auto& instance = instanceCache[id_];
+        if (!instance)
+            instance = &makeInstance();
+        return *instance;
+    }
+
+private:
+    T& makeInstance()
+    {
+        auto instance = instanceFactory_();
+        auto lock = std::lock_guard{mutex_};
+        return instances_.emplace_back(std::move(instance))->value;
+    }
+
+    static std::uint64_t nextId()
+    {
+        static auto counter = std::atomic<std::uint64_t>{};
+        return ++counter;
+    }
+
+private:
+    std::function<std::unique_ptr<Instance>()> instanceFactory_;
+    std::uint64_t id_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Instance>> instances_;
+};
+
+} // namespace whaleroute::detail
+
+#endif // WHALEROUTE_PERTHREADINSTANCE_H
@@ -1,18 +1,28 @@
 #ifndef WHALEROUTE_REQUESTPROCESSOR_H
 #define WHALEROUTE_REQUESTPROCESSOR_H
 
+#include "requestprocessorqueue.h"
+#include "responsecache.h"
+#include "task.h"
 #include "utils.h"
 #include "external/sfun/functional.h"
 #include "external/sfun/type_traits.h"
+#include <memory>
+#include <tuple>
+#include <type_traits>
 #include <variant>
 
 namespace whaleroute::detail {
 
+template<typename TRequest, typename TResponse, typename TRouteContext>
+using RequestProcessorFunc = std::function<
+        AsyncOperation(const TRequest&, TResponse&, const std::vector<std::string>&, TRouteContext&)>;
+
 template<typename TRequestProcessor, typename TRequest, typename TResponse, typename TRouteContext>
 constexpr void checkRequestProcessorSignature()
 {
     constexpr auto args = sfun::callable_args<TRequestProcessor>{};
-    using returnType = sfun::callable_return_type<TRequestProcessor>;
+    using returnType = UnwrapTaskType<sfun::callable_return_type<TRequestProcessor>>;
     if constexpr (std::is_same_v<returnType, void>) {
         static_assert(args.size() >= 2);
         if constexpr (std::is_same_v<TRouteContext, _>) {
@@ -150,48 +160,155 @@ constexpr int getParamsCount()
     };
 }
 
+// Response converters can provide the render(const TArgs&...) method, which creates a representation of the values
+// of Route::set once at the route registration. It's passed to the converter instead of the values for each request.
+template<typename TResponseConverter, typename TArgsTuple, typename = void>
+struct HasResponseRendering : std::false_type {};
+
+template<typename TResponseConverter, typename... TArgs>
+struct HasResponseRendering<
+        TResponseConverter,
+        std::tuple<TArgs...>,
+        std::void_t<decltype(std::declval<TResponseConverter&>().render(std::declval<const TArgs&>()...))>>
+    : std::true_type {};
+
+// Cached responses are stored rendered if the response converter supports it
+template<typename TResponseConverter, typename TValue>
+auto makeCachedResponse(TValue&& value)
+{
+    if constexpr (HasResponseRendering<TResponseConverter, std::tuple<std::decay_t<TValue>>>::value)
+        return TResponseConverter{}.render(std::as_const(value));
+    else
+        return std::decay_t<TValue>{std::forward<TValue>(value)};
+}
+
+template<typename TResponseConverter, typename TValue>
+using CachedResponseType = decltype(makeCachedResponse<TResponseConverter>(std::declval<TValue>()));
+
+// Placeholder for the processors without a response cache
+struct NoResponseCache {};
+
+template<typename TResponseConverter, typename TRequestProcessor>
+constexpr bool isResponseCacheable()
+{
+    using ReturnType = sfun::callable_return_type<TRequestProcessor>;
+    return !std::is_same_v<TResponseConverter, _> && !std::is_same_v<ReturnType, void> && !IsTask<ReturnType>::value;
+}
+
+template<typename TResponseConverter, typename TRequestProcessor, typename = void>
+struct ResponseCacheFor {
+    using type = NoResponseCache;
+};
+
+template<typename TResponseConverter, typename TRequestProcessor>
+struct ResponseCacheFor<
+        TResponseConverter,
+        TRequestProcessor,
+        std::enable_if_t<isResponseCacheable<TResponseConverter, TRequestProcessor>()>> {
+    using type = ResponseCache<CachedResponseType<TResponseConverter, sfun::callable_return_type<TRequestProcessor>>>;
+};
+
+template<typename TResponseConverter, typename TResponse, typename TProcessorCall>
+AsyncOperation processRequestProcessorResult(TResponse& response, TProcessorCall&& processorCall)
+{
+    using ResultType = decltype(processorCall());
+    if constexpr (std::is_same_v<ResultType, void>) {
+        processorCall();
+        return {};
+    }
+    else if constexpr (IsTask<ResultType>::value)
+        return makeTaskOperation<TResponseConverter>(processorCall(), response);
+    else {
+        TResponseConverter{}(response, processorCall());
+        return {};
+    }
+}
+
 template<
         typename TResponseConverter,
         typename TRequestProcessor,
         typename TRequest,
         typename TResponse,
-        typename TRouteContext>
-void invokeRequestProcessor(
+        typename TRouteContext,
+        typename TResponseCache = NoResponseCache>
+AsyncOperation invokeRequestProcessor(
         TRequestProcessor& requestProcessor,
         const TRequest& request,
         TResponse& response,
         const std::vector<std::string>& routeParams,
         TRouteContext& routeContext,
-        std::function<void(const TRequest&, TResponse&, const RouteParameterError&)> routeParamErrorHandler)
+        std::function<void(const TRequest&, TResponse&, const RouteParameterError&)> routeParamErrorHandler,
+        TResponseCache* responseCache = nullptr)
 {
     checkRequestProcessorSignature<TRequestProcessor, TRequest, TResponse, TRouteContext>();
 
+    auto responseCacheKey = ResponseCacheKey{};
+    if constexpr (!std::is_same_v<TResponseCache, NoResponseCache>) {
+        if (responseCache) {
+            responseCacheKey = makeResponseCacheKey(routeParams);
+            if (const auto cachedResponse = responseCache->find(responseCacheKey)) {
+                TResponseConverter{}(response, *cachedResponse);
+                return {};
+            }
+        }
+    }
+
     constexpr auto args = sfun::callable_args<TRequestProcessor>{};
-    using ReturnType = sfun::callable_return_type<TRequestProcessor>;
+    using ReturnType = UnwrapTaskType<sfun::callable_return_type<TRequestProcessor>>;
     constexpr auto paramsCount = getParamsCount<decltype(args), TRouteContext, ReturnType>();
+    auto processResult = [&](auto&& processorCall) -> AsyncOperation
+    {
+        if constexpr (!std::is_same_v<TResponseCache, NoResponseCache>) {
+            if (responseCache) {
+                const auto cachedResponse = responseCache->insert(
+                        responseCacheKey,
+                        makeCachedResponse<TResponseConverter>(processorCall()));
+                TResponseConverter{}(response, *cachedResponse);
+                return {};
+            }
+        }
+        return processRequestProcessorResult<TResponseConverter>(response, processorCall);
+    };
+
     if constexpr (!paramsCount) {
         if constexpr (std::is_same_v<ReturnType, void>) {
             if constexpr (args.size() == 2)
-                requestProcessor(request, response);
+                return processResult(
+                        [&]
+                        {
+                            return requestProcessor(request, response);
+                        });
             else
-                requestProcessor(request, response, routeContext);
+                return processResult(
+                        [&]
+                        {
+                            return requestProcessor(request, response, routeContext);
+                        });
         }
         else {
             if constexpr (args.size() == 1)
-                TResponseConverter{}(response, requestProcessor(request));
+                return processResult(
+                        [&]
+                        {
+                            return requestProcessor(request);
+                        });
             else
-                TResponseConverter{}(response, requestProcessor(request, routeContext));
+                return processResult(
+                        [&]
+                        {
+                            return requestProcessor(request, routeContext);
+                        });
         }
     }
     else {
-        auto paramsResult = readRouteParams<decltype(args), paramsCount>(routeParams);
         auto paramsResultVisitor = sfun::overloaded{
-                [&](const RouteParameterError& error)
+                [&](const RouteParameterError& error) -> AsyncOperation
                 {
                     if (routeParamErrorHandler)
                         routeParamErrorHandler(request, response, error);
+                    return {};
                 },
-                [&](const auto& params)
+                [&](const auto& params) -> AsyncOperation
                 {
                     auto callProcess = [&](const auto&... param)
                     {
@@ -199,23 +316,61 @@ void invokeRequestProcessor(
                         constexpr auto paramsCount = getParamsCount<decltype(args), TRouteContext, ReturnType>();
                         if constexpr (std::is_same_v<ReturnType, void>) {
                             if constexpr (args.size() - paramsCount == 2)
-                                requestProcessor(param..., request, response);
+                                return processResult(
+                                        [&]
+                                        {
+                                            return requestProcessor(param..., request, response);
+                                        });
                             else
-                                requestProcessor(param..., request, response, routeContext);
+                                return processResult(
+                                        [&]
+                                        {
+                                            return requestProcessor(param..., request, response, routeContext);
+                                        });
                         }
                         else {
                             if constexpr (args.size() - paramsCount == 1)
-                                TResponseConverter{}(response, requestProcessor(param..., request));
+                                return processResult(
+                                        [&]
+                                        {
+                                            return requestProcessor(param..., request);
+                                        });
                             else
-                                TResponseConverter{}(response, requestProcessor(param..., request, routeContext));
+                                return processResult(
+                                        [&]
+                                        {
+                                            return requestProcessor(param..., request, routeContext);
+                                        });
                         }
                     };
-                    std::apply(callProcess, params);
+                    return std::apply(callProcess, params);
                 }};
 
-        std::visit(paramsResultVisitor, paramsResult);
+        if constexpr (IsTask<sfun::callable_return_type<TRequestProcessor>>::value) {
+            // Coroutine can refer to the route parameters, so they're stored until its completion
+            auto paramsResult =
+                    std::make_shared<const decltype(readRouteParams<decltype(args), paramsCount>(routeParams))>(
+                            readRouteParams<decltype(args), paramsCount>(routeParams));
+            auto asyncOperation = std::visit(paramsResultVisitor, *paramsResult);
+            if (!asyncOperation)
+                return {};
+            return [asyncOperation = std::move(asyncOperation),
+                    paramsResult](const Executor& executor, std::function<void()> onCompleted)
+            {
+                asyncOperation(
+                        executor,
+                        [paramsResult, onCompleted = std::move(onCompleted)]
+                        {
+                            onCompleted();
+                        });
+            };
+        }
+        else {
+            auto paramsResult = readRouteParams<decltype(args), paramsCount>(routeParams);
+            return std::visit(paramsResultVisitor, paramsResult);
+        }
     }
 }
 } // namespace whaleroute::detail
 
-#endif // WHALEROUTE_REQUESTPROCESSOR_H
\ No newline at end of file
+#endif // WHALEROUTE_REQUESTPROCESSOR_H
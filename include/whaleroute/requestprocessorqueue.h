@@ -1,13 +1,72 @@
 #ifndef WHALEROUTE_REQUESTPROCESSORQUEUE_H
 #define WHALEROUTE_REQUESTPROCESSORQUEUE_H
 
+#include "routecontextpool.h"
 #include "external/sfun/interface.h"
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace whaleroute::detail {
 
+/// Type-erased executor of the request processor queue, empty if the queue runs all processors inline
+using Executor = std::function<void(std::function<void()> task)>;
+
+template<typename TExecutor>
+using ExecutorPostResult = decltype(std::declval<TExecutor&>().post(std::declval<std::function<void()>>()));
+
+template<typename TExecutor, typename = void>
+struct IsExecutor : std::false_type {};
+
+template<typename TExecutor>
+struct IsExecutor<TExecutor, std::void_t<ExecutorPostResult<TExecutor>>> : std::true_type {};
+
+template<typename TExecutor>
+Executor makeExecutor(TExecutor& executor)
+{
+    return [&executor](std::function<void()> task)
+    {
+        executor.post(std::move(task));
+    };
+}
+
+/// Asynchronous operation returned by a request processor, it must invoke the passed callback on completion
+using AsyncOperation = std::function<void(const Executor& executor, std::function<void()> onCompleted)>;
+
+/// Asynchronous operation that reports on completion whether the request processing should continue
+using AsyncInvocation =
+        std::function<void(const Executor& executor, std::function<void(bool canContinue)> onCompleted)>;
+
+/// Result of a request processor invocation: whether the request processing should continue,
+/// or an asynchronous operation that reports it on completion
+using InvocationResult = std::variant<bool, AsyncInvocation>;
+
+template<typename TRouteContext>
+using RequestProcessorInvoker = std::function<InvocationResult(TRouteContext&)>;
+
+/// Appends the invokers of the next matched route to the queue, returns false if there are no more routes
+template<typename TRouteContext>
+using RequestProcessorInvokerSource = std::function<bool(std::vector<RequestProcessorInvoker<TRouteContext>>&)>;
+
+inline AsyncInvocation continueAfter(AsyncOperation asyncOperation, std::function<bool()> canContinue)
+{
+    return [asyncOperation = std::move(asyncOperation),
+            canContinue = std::move(canContinue)](const Executor& executor, std::function<void(bool)> onCompleted)
+    {
+        asyncOperation(
+                executor,
+                [canContinue, onCompleted = std::move(onCompleted)]
+                {
+                    onCompleted(canContinue());
+                });
+    };
+}
+
 class IRequestProcessorQueueImpl : private sfun::interface<IRequestProcessorQueueImpl> {
 public:
     virtual void launch() = 0;
@@ -15,38 +74,135 @@ public:
 };
 
 template<typename TRouteContext>
-class RequestProcessorQueueImpl : public IRequestProcessorQueueImpl {
+class RequestProcessorQueueImpl : public IRequestProcessorQueueImpl,
+                                  public std::enable_shared_from_this<RequestProcessorQueueImpl<TRouteContext>> {
+    enum class AsyncInvocationState {
+        Running,
+        Suspended,
+        Completed
+    };
+
 public:
-    explicit RequestProcessorQueueImpl(std::vector<std::function<bool(TRouteContext&)>> requestProcessorInvokers)
+    explicit RequestProcessorQueueImpl(
+            std::vector<RequestProcessorInvoker<TRouteContext>> requestProcessorInvokers,
+            std::shared_ptr<const void> routeTable = {},
+            Executor executor = {},
+            RequestProcessorInvokerSource<TRouteContext> requestProcessorInvokerSource = {},
+            std::shared_ptr<RouteContextPool<TRouteContext>> routeContextPool = {})
         : requestProcessorInvokers_{std::move(requestProcessorInvokers)}
+        , requestProcessorInvokerSource_{std::move(requestProcessorInvokerSource)}
+        , routeTable_{std::move(routeTable)}
+        , executor_{std::move(executor)}
+        , routeContextPool_{std::move(routeContextPool)}
+        , routeContext_{makeRouteContext(routeContextPool_.get())}
     {
     }
     RequestProcessorQueueImpl() = default;
 
+    ~RequestProcessorQueueImpl()
+    {
+        if constexpr (isPoolableRouteContext<TRouteContext>)
+            if (routeContextPool_)
+                routeContextPool_->release(routeContext_);
+    }
+
+    RequestProcessorQueueImpl(const RequestProcessorQueueImpl&) = delete;
+    RequestProcessorQueueImpl& operator=(const RequestProcessorQueueImpl&) = delete;
+
     void launch() override
     {
         isStopped_ = false;
-        for (; currentIndex_ < requestProcessorInvokers_.size(); ++currentIndex_) {
+        invokeRequestProcessors();
+    }
+
+    void stop() override
+    {
+        isStopped_ = true;
+    }
+
+private:
+    void invokeRequestProcessors()
+    {
+        for (; hasRequestProcessorInvoker(); ++currentIndex_) {
             if (isStopped_)
                 break;
             auto result = requestProcessorInvokers_.at(currentIndex_)(routeContext_);
-            if (!result) {
-                currentIndex_ = requestProcessorInvokers_.size() + 1;
+            if (auto asyncInvocation = std::get_if<AsyncInvocation>(&result)) {
+                const auto canContinue = launchAsyncInvocation(*asyncInvocation);
+                if (!canContinue.has_value())
+                    return; // The processing is resumed by the completion handler
+                result = *canContinue;
+            }
+            if (!std::get<bool>(result)) {
+                finish();
                 break;
             }
         }
     }
 
-    void stop() override
+    // The invokers of the following routes are requested from the source when the queue reaches its end
+    bool hasRequestProcessorInvoker()
     {
-        isStopped_ = true;
+        while (currentIndex_ == requestProcessorInvokers_.size() && requestProcessorInvokerSource_)
+            if (!requestProcessorInvokerSource_(requestProcessorInvokers_))
+                requestProcessorInvokerSource_ = {};
+        return currentIndex_ < requestProcessorInvokers_.size();
+    }
+
+    // Returns the invocation result if it has completed synchronously
+    std::optional<bool> launchAsyncInvocation(const AsyncInvocation& asyncInvocation)
+    {
+        asyncInvocationState_ = AsyncInvocationState::Running;
+        asyncInvocation(
+                executor_,
+                [self = this->shared_from_this()](bool canContinue)
+                {
+                    self->onAsyncInvocationCompleted(canContinue);
+                });
+        if (asyncInvocationState_.exchange(AsyncInvocationState::Suspended) == AsyncInvocationState::Completed)
+            return asyncInvocationResult_;
+        return std::nullopt;
+    }
+
+    void onAsyncInvocationCompleted(bool canContinue)
+    {
+        asyncInvocationResult_ = canContinue;
+        if (asyncInvocationState_.exchange(AsyncInvocationState::Completed) != AsyncInvocationState::Suspended)
+            return;
+
+        if (!canContinue) {
+            finish();
+            return;
+        }
+        ++currentIndex_;
+        invokeRequestProcessors();
+    }
+
+    static TRouteContext makeRouteContext(RouteContextPool<TRouteContext>* routeContextPool)
+    {
+        if constexpr (isPoolableRouteContext<TRouteContext>)
+            if (routeContextPool)
+                return routeContextPool->acquire();
+        return TRouteContext{};
+    }
+
+    void finish()
+    {
+        currentIndex_ = requestProcessorInvokers_.size() + 1;
+        requestProcessorInvokerSource_ = {};
     }
 
 private:
     std::size_t currentIndex_ = 0;
     bool isStopped_ = false;
-    std::vector<std::function<bool(TRouteContext&)>> requestProcessorInvokers_;
+    std::vector<RequestProcessorInvoker<TRouteContext>> requestProcessorInvokers_;
+    RequestProcessorInvokerSource<TRouteContext> requestProcessorInvokerSource_;
+    std::shared_ptr<const void> routeTable_;
+    Executor executor_;
+    std::shared_ptr<RouteContextPool<TRouteContext>> routeContextPool_;
     TRouteContext routeContext_;
+    std::atomic<AsyncInvocationState> asyncInvocationState_ = AsyncInvocationState::Running;
+    bool asyncInvocationResult_ = false;
 };
 
 } //namespace whaleroute::detail
@@ -56,8 +212,18 @@ namespace whaleroute {
 class RequestProcessorQueue {
 public:
     template<typename TRouteContext>
-    explicit RequestProcessorQueue(std::vector<std::function<bool(TRouteContext&)>> requestProcessorInvokers)
-        : impl_{std::make_shared<detail::RequestProcessorQueueImpl<TRouteContext>>(requestProcessorInvokers)}
+    explicit RequestProcessorQueue(
+            std::vector<detail::RequestProcessorInvoker<TRouteContext>> requestProcessorInvokers,
+            std::shared_ptr<const void> routeTable = {},
+            detail::Executor executor = {},
+            detail::RequestProcessorInvokerSource<TRouteContext> requestProcessorInvokerSource = {},
+            std::shared_ptr<detail::RouteContextPool<TRouteContext>> routeContextPool = {})
+        : impl_{std::make_shared<detail::RequestProcessorQueueImpl<TRouteContext>>(
+                  std::move(requestProcessorInvokers),
+                  std::move(routeTable),
+                  std::move(executor),
+                  std::move(requestProcessorInvokerSource),
+                  std::move(routeContextPool))}
     {
     }
     RequestProcessorQueue() = default;
@@ -80,4 +246,4 @@ private:
 
 } // namespace whaleroute
 
-#endif // WHALEROUTE_REQUESTPROCESSORQUEUE_H
\ No newline at end of file
+#endif // WHALEROUTE_REQUESTPROCESSORQUEUE_H
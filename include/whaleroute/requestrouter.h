@@ -1,44 +1,119 @@
 #ifndef WHALEROUTE_REQUESTROUTER_H
 #define WHALEROUTE_REQUESTROUTER_H
 
+#include "frozenrequestrouter.h"
 #include "irequestrouter.h"
+#include "lazyregex.h"
 #include "requestprocessorqueue.h"
 #include "route.h"
+#include "routeanalysis.h"
+#include "routecontextpool.h"
+#include "routegroup.h"
+#include "routespec.h"
+#include "routestatistics.h"
+#include "routetable.h"
+#include "routetablesnapshot.h"
+#include "routetracer.h"
 #include "types.h"
 #include "utils.h"
 #include "external/sfun/functional.h"
 #include "external/sfun/interface.h"
+#include <algorithm>
+#include <chrono>
 #include <deque>
+#include <memory>
+#include <optional>
 #include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <variant>
+#include <vector>
 
 namespace whaleroute {
 
 template<typename TRequest, typename TResponse, typename TResponseConverter = _, typename TRouteContext = _>
 class RequestRouter : private detail::IRequestRouter<TRequest, TResponse> {
     using Route = detail::Route<TRequest, TResponse, TResponseConverter, TRouteContext>;
-    using RequestProcessorFunc =
-            std::function<void(const TRequest&, TResponse&, const std::vector<std::string>&, TRouteContext&)>;
+    using RouteTable = detail::RouteTable<TRequest, TResponse, TRouteContext>;
+    using RequestProcessorFunc = detail::RequestProcessorFunc<TRequest, TResponse, TRouteContext>;
+    using RouteGroup = detail::RouteGroup<TRequest, TResponse, TResponseConverter, TRouteContext>;
+    using RouteMatcherList = std::vector<detail::RouteMatcherInvoker<TRequest, TRouteContext>>;
+    using FrozenRouter = FrozenRequestRouter<TRequest, TResponse, TResponseConverter, TRouteContext>;
+    friend FrozenRouter;
+    friend RouteGroup;
+    friend class RequestRouterHandle<TRequest, TResponse, TResponseConverter, TRouteContext>;
 
     struct RegExpRouteMatch {
-        std::regex regExp;
+        const detail::LazyRegex* regExp;
+        std::string pattern;
         Route route;
+        std::optional<std::size_t> groupIndex;
     };
     struct PathRouteMatch {
         std::string path;
         Route route;
+        std::optional<std::size_t> groupIndex;
     };
     using RouteMatch = std::variant<RegExpRouteMatch, PathRouteMatch>;
+    struct MountedRouter {
+        std::string prefix;
+        RequestRouter* router;
+        std::size_t position;
+    };
 
 public:
+    using RouteSpec = whaleroute::RouteSpec<TRequest, TResponse, TResponseConverter, TRouteContext>;
+
     RequestRouter()
         : noMatchRoute_{{}, routeParametersErrorHandler()}
     {
+        routeTable_.setUnmatchedRequestProcessors(noMatchRoute_.getRequestProcessors());
     }
 
     void setTrailingSlashMode(TrailingSlashMode mode)
     {
         trailingSlashMode_ = mode;
+        routeTable_.setTrailingSlashMode(mode);
+    }
+
+    /// In MatchingMode::FirstMatch, requests are processed only by the routes with the most specific matching path:
+    /// literal paths are preferred over regular expressions capturing whole segments, catch-all routes and mounted
+    /// routers with longer prefixes and other regular expressions. Route lookup stops at the first match.
+    void setMatchingMode(MatchingMode mode)
+    {
+        routeTable_.setMatchingMode(mode);
+    }
+
+    /// Enables matching of the regular expression routes in parallel on the executor, which must provide
+    /// the post(callable) method and outlive the router. Routes are split into shardCount parts,
+    /// tables with fewer than minRouteCount regular expression routes are still matched serially.
+    template<typename TExecutor, std::enable_if_t<detail::IsExecutor<TExecutor>::value>* = nullptr>
+    void enableParallelMatching(TExecutor& executor, std::size_t shardCount, std::size_t minRouteCount = 1000)
+    {
+        routeTable_.setParallelMatching({detail::makeExecutor(executor), shardCount, minRouteCount});
+    }
+
+    void disableParallelMatching()
+    {
+        routeTable_.setParallelMatching({});
+    }
+
+    /// Enables reusing the route contexts of the processed requests instead of creating them for each request.
+    /// Contexts are cleared with config::RouteContextReset, up to maxSizePerThread of them are kept by each thread.
+    /// Like route registration, it must not be called concurrently with request processing.
+    void enableRouteContextPool(std::size_t maxSizePerThread = 64)
+    {
+        static_assert(
+                detail::isPoolableRouteContext<TRouteContext>,
+                "Pooled route contexts must be move constructible and move assignable");
+        routeContextPool_ = std::make_shared<detail::RouteContextPool<TRouteContext>>(maxSizePerThread);
+    }
+
+    void disableRouteContextPool()
+    {
+        routeContextPool_ = {};
     }
 
     template<typename... TRouteMatcherArgs>
@@ -68,6 +143,121 @@ public:
         return noMatchRoute_;
     }
 
+    /// Creates a group for registering the routes with the common path prefix and route matchers.
+    /// The prefix and the matchers are checked once per request for all routes of the group.
+    template<typename... TRouteMatcherArgs>
+    RouteGroup& group(const std::string& prefix, TRouteMatcherArgs&&... matcherArgs)
+    {
+        return groupImpl(detail::makeRouteGroupPrefix(prefix), {std::forward<TRouteMatcherArgs>(matcherArgs)...});
+    }
+
+    /// Mounts the sub-router under the prefix, requests with paths starting with it are also matched with its routes
+    /// using the rest of the path. Its matches are processed in place of a route registered at this point.
+    /// The sub-router must outlive this router and use the same trailing slash mode, its getRequestPath and unmatched
+    /// request processing aren't used. Route ids passed to the tracer and statistics are the ones of the sub-router.
+    void mount(const std::string& prefix, RequestRouter& router)
+    {
+        auto& mountedRouter = mountedRouters_.emplace_back(
+                MountedRouter{detail::makeRouteGroupPrefix(prefix), &router, routeMatchList_.size()});
+        routeTable_.mount(mountedRouter.prefix, router.routeTable_);
+    }
+
+    /// Registers the routes from a range of RouteSpec objects in the range order.
+    /// The storage of the lookup structures is allocated once for all routes, so registering large generated route
+    /// tables isn't slowed down by the rehashing of the path index.
+    /// Invalid and duplicate specs are skipped and returned as errors. The range is iterated twice.
+    template<typename TRouteSpecRange>
+    std::vector<RouteSpecError> addRoutes(const TRouteSpecRange& routeSpecs)
+    {
+        auto errors = std::vector<RouteSpecError>{};
+        auto pathRouteCount = std::size_t{};
+        auto regexRouteCount = std::size_t{};
+        auto pathKeys = std::unordered_set<std::string>{};
+        auto regexKeys = std::unordered_set<std::string>{};
+        auto specIndex = std::size_t{};
+        for (const RouteSpec& spec : routeSpecs) {
+            const auto error = validateRouteSpec(spec, pathKeys, regexKeys);
+            if (error)
+                errors.push_back({specIndex, *error});
+            else if (std::holds_alternative<rx>(spec.path))
+                ++regexRouteCount;
+            else
+                ++pathRouteCount;
+            ++specIndex;
+        }
+
+        routeTable_.reserve(pathRouteCount, regexRouteCount);
+        regexCache_.reserve(regexCache_.size() + regexRouteCount);
+        specIndex = 0;
+        auto errorIt = errors.begin();
+        for (const RouteSpec& spec : routeSpecs) {
+            if (errorIt != errors.end() && errorIt->specIndex == specIndex++) {
+                ++errorIt;
+                continue;
+            }
+            auto& route = std::holds_alternative<rx>(spec.path)
+                    ? regexRouteImpl(std::get<rx>(spec.path), spec.matchers)
+                    : pathRouteImpl(std::get<std::string>(spec.path), spec.matchers);
+            spec.registerProcessors(route);
+        }
+        return errors;
+    }
+
+    /// Returns the route with the specified index in the order of registration.
+    /// Passed route matchers replace the route's matchers and are applied to the processors registered after the call.
+    template<typename... TRouteMatcherArgs>
+    Route& routeById(std::size_t routeId, TRouteMatcherArgs&&... matcherArgs)
+    {
+        auto& route = std::visit(
+                [](auto& match) -> Route&
+                {
+                    return match.route;
+                },
+                routeMatchList_.at(routeId));
+        if constexpr (sizeof...(TRouteMatcherArgs) > 0)
+            route.setRouteMatchers({std::forward<TRouteMatcherArgs>(matcherArgs)...});
+        return route;
+    }
+
+    /// Serializes the paths and regular expressions of the registered routes along with the trailing slash mode.
+    /// Processors and route matchers aren't stored.
+    std::string saveRouteTable() const
+    {
+        auto snapshot = detail::RouteTableSnapshot{trailingSlashMode_, {}};
+        auto addRoute = [&](const auto& match)
+        {
+            const auto routeId = snapshot.routes.size();
+            if constexpr (std::is_same_v<std::decay_t<decltype(match)>, RegExpRouteMatch>)
+                snapshot.routes.push_back({routeId, detail::SnapshotRouteKind::Regex, match.pattern});
+            else
+                snapshot.routes.push_back({routeId, detail::SnapshotRouteKind::Path, match.path});
+        };
+        for (const auto& match : routeMatchList_)
+            std::visit(addRoute, match);
+        return detail::RouteTableSnapshotWriter{}.write(snapshot);
+    }
+
+    /// Registers the routes from the data created by saveRouteTable, which can be a memory-mapped file.
+    /// Route ids match the ones of the saved router, use routeById to register the processors of the loaded routes.
+    /// Returns false if the data is invalid or the router already has registered routes.
+    bool loadRouteTable(std::string_view data)
+    {
+        if (!routeMatchList_.empty())
+            return false;
+        const auto snapshot = detail::RouteTableSnapshotReader{data}.read();
+        if (!snapshot)
+            return false;
+
+        setTrailingSlashMode(snapshot->trailingSlashMode);
+        for (const auto& route : snapshot->routes) {
+            if (route.kind == detail::SnapshotRouteKind::Regex)
+                regexRouteImpl(rx{route.value});
+            else
+                pathRouteImpl(route.value);
+        }
+        return true;
+    }
+
     void process(const TRequest& request, TResponse& response)
     {
         auto queue = makeRequestProcessorQueue(request, response);
@@ -76,24 +266,116 @@ public:
 
     RequestProcessorQueue makeRequestProcessorQueue(const TRequest& request, TResponse& response)
     {
-        auto requestProcessorInvokerList = makeRouteRequestProcessorInvokerList(request, response);
-        for (const auto& processor : noMatchRoute_.getRequestProcessors())
-            requestProcessorInvokerList.emplace_back(
-                    [request, response, processor](TRouteContext& routeContext) mutable -> bool
-                    {
-                        processor(request, response, {}, routeContext);
-                        return false;
-                    });
+        return makeRequestProcessorQueue(routeTable_, request, response);
+    }
 
-        if (requestProcessorInvokerList.empty())
-            requestProcessorInvokerList.emplace_back(
-                    [request, response, this](TRouteContext&) mutable -> bool
-                    {
-                        this->processUnmatchedRequest(request, response);
-                        return false;
-                    });
+    /// Processors registered with Route::processOffloaded are posted to the executor,
+    /// which must provide the post(callable) method.
+    template<typename TExecutor, std::enable_if_t<detail::IsExecutor<TExecutor>::value>* = nullptr>
+    void process(const TRequest& request, TResponse& response, TExecutor& executor)
+    {
+        auto queue = makeRequestProcessorQueue(request, response, executor);
+        queue.launch();
+    }
+
+    /// The executor must outlive the returned queue.
+    template<typename TExecutor, std::enable_if_t<detail::IsExecutor<TExecutor>::value>* = nullptr>
+    RequestProcessorQueue makeRequestProcessorQueue(const TRequest& request, TResponse& response, TExecutor& executor)
+    {
+        return makeRequestProcessorQueue(routeTable_, request, response, detail::makeExecutor(executor));
+    }
+
+    /// Enables collecting of the RouteStatistics for all registered routes.
+    /// Like route registration, it must not be called concurrently with request processing.
+    void enableRouteStatistics(RouteStatisticsLevel level = RouteStatisticsLevel::Counters)
+    {
+        routeStatisticsLevel_ = level;
+        if (level == RouteStatisticsLevel::LatencyHistograms && !routingLatency_)
+            routingLatency_ = std::make_unique<detail::LatencyRecorder>();
+        for (auto routeIndex = std::size_t{}; routeIndex < routeMatchList_.size(); ++routeIndex)
+            routeTable_.setRouteCounters(routeIndex, &routeById(routeIndex).enableCounters(level));
+    }
+
+    /// Returns the statistics of the routes in the order of their registration,
+    /// including requests processed by the frozen routers created from this router.
+    std::vector<RouteStatistics> routeStatistics() const
+    {
+        auto result = std::vector<RouteStatistics>{};
+        auto routeIndex = std::size_t{};
+        auto addRouteStatistics = [&](const auto& match)
+        {
+            if (const auto counters = match.route.counters()) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(match)>, RegExpRouteMatch>)
+                    result.push_back(counters->statistics(routeIndex, match.pattern));
+                else
+                    result.push_back(counters->statistics(routeIndex, match.path));
+            }
+            ++routeIndex;
+        };
+        for (const auto& match : routeMatchList_)
+            std::visit(addRouteStatistics, match);
+        return result;
+    }
+
+    /// Returns the latencies of the route matching, collected with RouteStatisticsLevel::LatencyHistograms.
+    /// Together with the route latencies, it allows telling the routing overhead apart from the processing time.
+    LatencyHistogram routingLatency() const
+    {
+        if (!routingLatency_)
+            return {};
+        return routingLatency_->histogram();
+    }
+
+    /// Compiles the regular expressions of the registered routes, which are otherwise compiled on the first match.
+    /// Throws std::regex_error if any of them is invalid.
+    void warmUp()
+    {
+        for (const auto& [pattern, regExp] : regexCache_)
+            regExp.get();
+    }
+
+    /// Reports the routes that are shadowed by earlier routes, the regular expression routes that can be replaced with
+    /// simpler ones and the estimated cost of matching a request path.
+    /// The analysis compares each route with all earlier routes, so it's intended for tests and tooling.
+    RouteTableAnalysis analyzeRoutes() const
+    {
+        auto analyzer = detail::RouteTableAnalyzer{trailingSlashMode_};
+        auto addRoute = [&](const auto& match)
+        {
+            const auto canShadowRoutes =
+                    !match.route.hasRouteMatchers() && !match.route.getRequestProcessors().empty();
+            if constexpr (std::is_same_v<std::decay_t<decltype(match)>, RegExpRouteMatch>)
+                analyzer.addRegexRoute(match.pattern, *match.regExp, canShadowRoutes);
+            else
+                analyzer.addPathRoute(match.path, canShadowRoutes);
+        };
+        for (const auto& match : routeMatchList_)
+            std::visit(addRoute, match);
+        return analyzer.result();
+    }
+
+    /// Processes a batch of requests, each request is processed with the response at the same index.
+    /// The route matching is performed once for each distinct request path in the batch.
+    void process(const std::vector<TRequest>& requests, std::vector<TResponse>& responses)
+    {
+        for (auto& queue : makeRequestProcessorQueues(requests, responses))
+            queue.launch();
+    }
 
-        return RequestProcessorQueue{requestProcessorInvokerList};
+    std::vector<RequestProcessorQueue> makeRequestProcessorQueues(
+            const std::vector<TRequest>& requests,
+            std::vector<TResponse>& responses)
+    {
+        return makeRequestProcessorQueues(routeTable_, requests, responses);
+    }
+
+    /// Creates an immutable snapshot of the registered routes.
+    /// The returned router can be used to process requests from any number of threads concurrently,
+    /// routes registered or modified after the call don't affect it.
+    /// The RequestRouter object must outlive the returned router and the request processor queues created by it.
+    FrozenRouter freeze()
+    {
+        return makeFrozenRouter({});
     }
 
 private:
@@ -110,64 +392,318 @@ private:
         };
     }
 
-    auto makeRegexMatchProcessor(const TRequest& request, TResponse& response)
+    FrozenRouter makeFrozenRouter(std::shared_ptr<const void> routerOwner)
     {
-        return [&](const RegExpRouteMatch& match) -> std::vector<std::function<bool(TRouteContext&)>>
-        {
-            auto matchList = std::smatch{};
-            const auto requestPath = detail::makePath(this->getRequestPath(request), trailingSlashMode_);
-            if (!std::regex_match(requestPath, matchList, match.regExp))
-                return {};
-
-            auto routeParams = std::vector<std::string>{};
-            for (auto i = 1u; i < matchList.size(); ++i)
-                routeParams.push_back(matchList[i].str());
-            return makeRequestProcessorInvokerList(match.route.getRequestProcessors(), request, response, routeParams);
-        };
+        return FrozenRouter{*this, makeFrozenRouteTable(std::move(routerOwner))};
     }
 
-    auto makePathMatchProcessor(const TRequest& request, TResponse& response)
+    // Mounted sub-routers are frozen along with this router, their tables are owned by the created table
+    std::shared_ptr<RouteTable> makeFrozenRouteTable(std::shared_ptr<const void> routerOwner)
     {
-        return [&](const PathRouteMatch& match) -> std::vector<std::function<bool(TRouteContext&)>>
+        auto routeTable = std::make_shared<RouteTable>(trailingSlashMode_, std::move(routerOwner));
+        routeTable->setParallelMatching(routeTable_.parallelMatching());
+        routeTable->setMatchingMode(routeTable_.matchingMode());
+        for (const auto& group : routeGroups_)
+            routeTable->addRouteGroup(group.prefix(), group.routeMatchers());
+        auto addRoute = [&](const auto& match)
         {
-            if (match.path == detail::makePath(this->getRequestPath(request), trailingSlashMode_))
-                return makeRequestProcessorInvokerList(match.route.getRequestProcessors(), request, response, {});
+            const auto& processorList = routeTable->storeProcessorList(match.route.getRequestProcessors());
+            if constexpr (std::is_same_v<std::decay_t<decltype(match)>, RegExpRouteMatch>)
+                routeTable->addRoute(*match.regExp, processorList, match.route.counters(), match.groupIndex);
             else
-                return {};
+                routeTable->addRoute(match.path, processorList, match.route.counters(), match.groupIndex);
+        };
+        auto mountedRouterIt = mountedRouters_.begin();
+        auto mountRoutersBefore = [&](std::size_t routeIndex)
+        {
+            for (; mountedRouterIt != mountedRouters_.end() && mountedRouterIt->position <= routeIndex;
+                 ++mountedRouterIt) {
+                auto mountedRouteTable = mountedRouterIt->router->makeFrozenRouteTable({});
+                routeTable->mount(mountedRouterIt->prefix, *mountedRouteTable, mountedRouteTable);
+            }
         };
+        for (auto routeIndex = std::size_t{}; routeIndex < routeMatchList_.size(); ++routeIndex) {
+            mountRoutersBefore(routeIndex);
+            std::visit(addRoute, routeMatchList_[routeIndex]);
+        }
+        mountRoutersBefore(routeMatchList_.size());
+        routeTable->setUnmatchedRequestProcessors(
+                routeTable->storeProcessorList(noMatchRoute_.getRequestProcessors()));
+        return routeTable;
     }
 
-    std::vector<std::function<bool(TRouteContext&)>> makeRouteRequestProcessorInvokerList(
+    RequestProcessorQueue makeRequestProcessorQueue(
+            const RouteTable& routeTable,
             const TRequest& request,
-            TResponse& response)
+            TResponse& response,
+            detail::Executor executor = {},
+            std::shared_ptr<const RouteTable> routeTableOwner = {})
     {
-        auto result = std::vector<std::function<bool(TRouteContext&)>>{};
-        const auto matchVisitor =
-                sfun::overloaded{makeRegexMatchProcessor(request, response), makePathMatchProcessor(request, response)};
-        for (auto& match : routeMatchList_)
-            detail::concat(result, std::visit(matchVisitor, match));
+        const auto startTime =
+                routingLatency_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+        auto requestPath = detail::makePath(this->getRequestPath(request), routeTable.trailingSlashMode());
+        if (routeTable.canMatchIncrementally())
+            return makeIncrementalRequestProcessorQueue(
+                    routeTable,
+                    std::move(requestPath),
+                    startTime,
+                    request,
+                    response,
+                    std::move(executor),
+                    std::move(routeTableOwner));
+
+        const auto matchList = routeTable.match(requestPath);
+        if (routingLatency_)
+            routingLatency_->record(std::chrono::steady_clock::now() - startTime);
+        return makeRequestProcessorQueue(
+                routeTable,
+                matchList,
+                request,
+                response,
+                std::move(executor),
+                std::move(routeTableOwner));
+    }
 
+    std::vector<RequestProcessorQueue> makeRequestProcessorQueues(
+            const RouteTable& routeTable,
+            const std::vector<TRequest>& requests,
+            std::vector<TResponse>& responses,
+            std::shared_ptr<const RouteTable> routeTableOwner = {})
+    {
+        auto result = std::vector<RequestProcessorQueue>{};
+        result.reserve(requests.size());
+        // Requests with the same path share the results of the route matching
+        auto matchesByPath = std::unordered_map<std::string, std::vector<typename RouteTable::RouteMatch>>{};
+        for (auto i = std::size_t{}; i < requests.size(); ++i) {
+            const auto& request = requests[i];
+            const auto startTime =
+                    routingLatency_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+            auto requestPath = detail::makePath(this->getRequestPath(request), routeTable.trailingSlashMode());
+            auto it = matchesByPath.find(requestPath);
+            if (it == matchesByPath.end()) {
+                auto matchList = routeTable.match(requestPath);
+                it = matchesByPath.emplace(std::move(requestPath), std::move(matchList)).first;
+            }
+            if (routingLatency_)
+                routingLatency_->record(std::chrono::steady_clock::now() - startTime);
+            result.emplace_back(
+                    makeRequestProcessorQueue(routeTable, it->second, request, responses.at(i), {}, routeTableOwner));
+        }
         return result;
     }
 
-    std::vector<std::function<bool(TRouteContext&)>> makeRequestProcessorInvokerList(
-            const std::vector<RequestProcessorFunc>& processorList,
+    // Matched routes of the same group share the result of the group matchers
+    using GroupMatchList = std::vector<std::shared_ptr<detail::RouteGroupMatch<TRequest, TRouteContext>>>;
+
+    // Routes are matched while the queue is processed, so the regular expressions of the routes after the one
+    // that finishes the processing aren't matched. The routing latency covers finding the first matched route.
+    RequestProcessorQueue makeIncrementalRequestProcessorQueue(
+            const RouteTable& routeTable,
+            std::string requestPath,
+            std::chrono::steady_clock::time_point startTime,
             const TRequest& request,
             TResponse& response,
-            const std::vector<std::string>& routeParams)
+            detail::Executor executor,
+            std::shared_ptr<const RouteTable> routeTableOwner)
+    {
+        auto matchCursor = routeTable.matchIncrementally(std::move(requestPath));
+        auto firstMatch = matchCursor.next();
+        if (routingLatency_)
+            routingLatency_->record(std::chrono::steady_clock::now() - startTime);
+
+        auto requestProcessorInvokerList = std::vector<detail::RequestProcessorInvoker<TRouteContext>>{};
+        if (!firstMatch) {
+            detail::traceRequestUnmatched(request);
+            addUnmatchedRequestInvokers(requestProcessorInvokerList, routeTable, request, response);
+            return RequestProcessorQueue{
+                    std::move(requestProcessorInvokerList),
+                    std::move(routeTableOwner),
+                    std::move(executor),
+                    {},
+                    routeContextPool_};
+        }
+
+        auto groupMatches = GroupMatchList{};
+        addRouteMatchInvokers(requestProcessorInvokerList, *firstMatch, groupMatches, request, response);
+        auto requestProcessorInvokerSource = detail::RequestProcessorInvokerSource<TRouteContext>{
+                [this,
+                 &routeTable,
+                 matchCursor = std::move(matchCursor),
+                 groupMatches = std::move(groupMatches),
+                 request,
+                 response](std::vector<detail::RequestProcessorInvoker<TRouteContext>>& invokers) mutable -> bool
+        {
+            if (auto match = matchCursor.next()) {
+                addRouteMatchInvokers(invokers, *match, groupMatches, request, response);
+                return true;
+            }
+            addUnmatchedRequestInvokers(invokers, routeTable, request, response);
+            return false;
+        }};
+        return RequestProcessorQueue{
+                std::move(requestProcessorInvokerList),
+                std::move(routeTableOwner),
+                std::move(executor),
+                std::move(requestProcessorInvokerSource),
+                routeContextPool_};
+    }
+
+    RequestProcessorQueue makeRequestProcessorQueue(
+            const RouteTable& routeTable,
+            const std::vector<typename RouteTable::RouteMatch>& matchList,
+            const TRequest& request,
+            TResponse& response,
+            detail::Executor executor,
+            std::shared_ptr<const RouteTable> routeTableOwner)
+    {
+        auto requestProcessorInvokerList = std::vector<detail::RequestProcessorInvoker<TRouteContext>>{};
+        auto groupMatches = GroupMatchList{};
+        for (const auto& match : matchList)
+            addRouteMatchInvokers(requestProcessorInvokerList, match, groupMatches, request, response);
+        if (matchList.empty())
+            detail::traceRequestUnmatched(request);
+        addUnmatchedRequestInvokers(requestProcessorInvokerList, routeTable, request, response);
+
+        return RequestProcessorQueue{
+                std::move(requestProcessorInvokerList),
+                std::move(routeTableOwner),
+                std::move(executor),
+                {},
+                routeContextPool_};
+    }
+
+    void addRouteMatchInvokers(
+            std::vector<detail::RequestProcessorInvoker<TRouteContext>>& requestProcessorInvokerList,
+            const typename RouteTable::RouteMatch& match,
+            GroupMatchList& groupMatches,
+            const TRequest& request,
+            TResponse& response)
+    {
+        if (match.counters)
+            match.counters->addMatch();
+        detail::traceRouteMatched(request, match.routeIndex);
+        auto groupMatch = std::shared_ptr<detail::RouteGroupMatch<TRequest, TRouteContext>>{};
+        if (match.groupMatchers) {
+            auto it = std::find_if(
+                    groupMatches.begin(),
+                    groupMatches.end(),
+                    [&match](const auto& groupMatch)
+                    {
+                        return &groupMatch->routeMatchers() == match.groupMatchers;
+                    });
+            if (it == groupMatches.end())
+                it = groupMatches.insert(
+                        it,
+                        std::make_shared<detail::RouteGroupMatch<TRequest, TRouteContext>>(*match.groupMatchers));
+            groupMatch = *it;
+        }
+        detail::concat(
+                requestProcessorInvokerList,
+                makeRequestProcessorInvokerList(match, std::move(groupMatch), request, response));
+    }
+
+    void addUnmatchedRequestInvokers(
+            std::vector<detail::RequestProcessorInvoker<TRouteContext>>& requestProcessorInvokerList,
+            const RouteTable& routeTable,
+            const TRequest& request,
+            TResponse& response)
     {
-        auto result = std::vector<std::function<bool(TRouteContext&)>>{};
-        for (const auto& processor : processorList) {
+        const auto hasRouteInvokers = !requestProcessorInvokerList.empty();
+        for (const auto& processor : routeTable.unmatchedRequestProcessors())
+            requestProcessorInvokerList.emplace_back(
+                    [request, response, &processor](TRouteContext& routeContext) mutable -> detail::InvocationResult
+                    {
+                        auto asyncOperation = processor(request, response, {}, routeContext);
+                        if (asyncOperation)
+                            return detail::continueAfter(
+                                    std::move(asyncOperation),
+                                    []
+                                    {
+                                        return false;
+                                    });
+                        return false;
+                    });
+
+        if (!hasRouteInvokers && routeTable.unmatchedRequestProcessors().empty())
+            requestProcessorInvokerList.emplace_back(
+                    [request, response, this](TRouteContext&) mutable -> detail::InvocationResult
+                    {
+                        this->processUnmatchedRequest(request, response);
+                        return false;
+                    });
+    }
+
+    std::vector<detail::RequestProcessorInvoker<TRouteContext>> makeRequestProcessorInvokerList(
+            const typename RouteTable::RouteMatch& match,
+            std::shared_ptr<detail::RouteGroupMatch<TRequest, TRouteContext>> groupMatch,
+            const TRequest& request,
+            TResponse& response)
+    {
+        const auto& processorList = *match.processorList;
+        const auto& routeParams = match.routeParams;
+        const auto counters = match.counters;
+        auto result = std::vector<detail::RequestProcessorInvoker<TRouteContext>>{};
+        // Start time of the route processing shared by the invokers of the route's processors
+        auto routeStartTime = (counters && counters->routeLatency())
+                ? std::make_shared<std::chrono::steady_clock::time_point>()
+                : nullptr;
+        for (auto processorIndex = std::size_t{}; processorIndex < processorList.size(); ++processorIndex) {
+            const auto& processor = processorList[processorIndex];
             auto checkIfFinished = (&processor == &processorList.back());
+            auto processorLatency = counters ? counters->processorLatency(processorIndex) : nullptr;
             result.emplace_back(
-                    [request, response, processor, checkIfFinished, routeParams, this](
-                            TRouteContext& routeContext) mutable -> bool
+                    [request,
+                     response,
+                     &processor,
+                     checkIfFinished,
+                     routeParams,
+                     counters,
+                     processorLatency,
+                     routeStartTime,
+                     groupMatch,
+                     routeId = match.routeIndex,
+                     processorIndex,
+                     this](TRouteContext& routeContext) mutable -> detail::InvocationResult
                     {
-                        processor(request, response, routeParams, routeContext);
-                        if (checkIfFinished)
-                            return !isRouteProcessingFinished(request, response);
-                        else
-                            return true;
+                        detail::traceProcessorStarted(request, routeId, processorIndex);
+                        auto startTime = std::chrono::steady_clock::time_point{};
+                        if (counters) {
+                            counters->addInvocation();
+                            startTime = std::chrono::steady_clock::now();
+                            if (routeStartTime && processorIndex == 0)
+                                *routeStartTime = startTime;
+                        }
+                        auto asyncOperation = (!groupMatch || (*groupMatch)(request, routeContext))
+                                ? processor(request, response, routeParams, routeContext)
+                                : detail::AsyncOperation{};
+                        auto canContinue = [&request,
+                                            &response,
+                                            checkIfFinished,
+                                            counters,
+                                            processorLatency,
+                                            routeStartTime,
+                                            startTime,
+                                            routeId,
+                                            processorIndex,
+                                            this]
+                        {
+                            detail::traceProcessorFinished(request, routeId, processorIndex);
+                            if (counters) {
+                                const auto endTime = std::chrono::steady_clock::now();
+                                counters->addProcessingTime(endTime - startTime);
+                                if (processorLatency)
+                                    processorLatency->record(endTime - startTime);
+                                if (routeStartTime && checkIfFinished)
+                                    counters->routeLatency()->record(endTime - *routeStartTime);
+                            }
+                            if (checkIfFinished)
+                                return !isRouteProcessingFinished(request, response);
+                            else
+                                return true;
+                        };
+                        if (asyncOperation)
+                            return detail::continueAfter(std::move(asyncOperation), canContinue);
+                        return canContinue();
                     });
         }
         return result;
@@ -175,28 +711,91 @@ private:
 
     Route& pathRouteImpl(
             const std::string& path,
-            std::vector<detail::RouteMatcherInvoker<TRequest, TRouteContext>> routeMatchers = {})
+            RouteMatcherList routeMatchers = {},
+            std::optional<std::size_t> groupIndex = {})
     {
         auto routePath = detail::makePath(path, trailingSlashMode_);
-        auto& routeMatch = routeMatchList_.emplace_back(
-                PathRouteMatch{routePath, Route{routeMatchers, routeParametersErrorHandler()}});
-        return std::get<PathRouteMatch>(routeMatch).route;
+        auto& routeMatch = std::get<PathRouteMatch>(routeMatchList_.emplace_back(
+                PathRouteMatch{routePath, Route{routeMatchers, routeParametersErrorHandler()}, groupIndex}));
+        routeTable_.addRoute(
+                routeMatch.path,
+                routeMatch.route.getRequestProcessors(),
+                makeRouteCounters(routeMatch),
+                groupIndex);
+        return routeMatch.route;
     }
 
     Route& regexRouteImpl(
             const rx& regExp,
-            std::vector<detail::RouteMatcherInvoker<TRequest, TRouteContext>> routeMatchers = {})
+            RouteMatcherList routeMatchers = {},
+            std::optional<std::size_t> groupIndex = {})
+    {
+        auto& routeMatch = std::get<RegExpRouteMatch>(routeMatchList_.emplace_back(RegExpRouteMatch{
+                &regex(detail::makeRegexPattern(regExp, trailingSlashMode_)),
+                regExp.value,
+                {std::move(routeMatchers), routeParametersErrorHandler()},
+                groupIndex}));
+        routeTable_.addRoute(
+                *routeMatch.regExp,
+                routeMatch.route.getRequestProcessors(),
+                makeRouteCounters(routeMatch),
+                groupIndex);
+        return routeMatch.route;
+    }
+
+    RouteGroup& groupImpl(const std::string& prefix, RouteMatcherList routeMatchers)
+    {
+        auto& group = routeGroups_.emplace_back(*this, routeGroups_.size(), prefix, std::move(routeMatchers));
+        routeTable_.addRouteGroup(group.prefix(), group.routeMatchers());
+        return group;
+    }
+
+    std::optional<RouteSpecErrorType> validateRouteSpec(
+            const RouteSpec& spec,
+            std::unordered_set<std::string>& pathKeys,
+            std::unordered_set<std::string>& regexKeys) const
+    {
+        const auto isRegex = std::holds_alternative<rx>(spec.path);
+        const auto& path = isRegex ? std::get<rx>(spec.path).value : std::get<std::string>(spec.path);
+        if (path.empty())
+            return RouteSpecErrorType::EmptyPath;
+        if (!spec.registerProcessors)
+            return RouteSpecErrorType::NoProcessors;
+        if (spec.matchers.empty()) {
+            auto& keys = isRegex ? regexKeys : pathKeys;
+            auto key = isRegex ? detail::makeRegexPattern(rx{path}, trailingSlashMode_)
+                               : detail::makePath(path, trailingSlashMode_);
+            if (!keys.insert(std::move(key)).second)
+                return RouteSpecErrorType::DuplicateRoute;
+        }
+        return std::nullopt;
+    }
+
+    // Routes with identical patterns share the same regular expression, which is compiled on the first match
+    const detail::LazyRegex& regex(const std::string& pattern)
+    {
+        return regexCache_.try_emplace(pattern, pattern).first->second;
+    }
+
+    template<typename TRouteMatch>
+    detail::RouteCounters* makeRouteCounters(TRouteMatch& routeMatch)
     {
-        auto& routeMatch = routeMatchList_.emplace_back(RegExpRouteMatch{
-                detail::makeRegex(regExp, trailingSlashMode_),
-                {std::move(routeMatchers), routeParametersErrorHandler()}});
-        return std::get<RegExpRouteMatch>(routeMatch).route;
+        if (!routeStatisticsLevel_)
+            return nullptr;
+        return &routeMatch.route.enableCounters(*routeStatisticsLevel_);
     }
 
 private:
+    std::unordered_map<std::string, detail::LazyRegex> regexCache_;
     std::deque<RouteMatch> routeMatchList_;
+    std::deque<RouteGroup> routeGroups_;
+    std::deque<MountedRouter> mountedRouters_;
     Route noMatchRoute_;
+    RouteTable routeTable_;
     TrailingSlashMode trailingSlashMode_ = TrailingSlashMode::Optional;
+    std::optional<RouteStatisticsLevel> routeStatisticsLevel_;
+    std::unique_ptr<detail::LatencyRecorder> routingLatency_;
+    std::shared_ptr<detail::RouteContextPool<TRouteContext>> routeContextPool_;
 };
 
 } // namespace whaleroute
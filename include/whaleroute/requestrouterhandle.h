@@ -0,0 +1,163 @@
+#ifndef WHALEROUTE_REQUESTROUTERHANDLE_H
+#define WHALEROUTE_REQUESTROUTERHANDLE_H
+
+#include "frozenrequestrouter.h"
+#include "requestprocessorqueue.h"
+#include "requestrouter.h"
+#include "types.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace whaleroute::detail {
+
+/// Shared pointer that can be replaced while other threads are reading it.
+/// The value is stored in one of two slots: readers only increment the counter of the current slot while copying the
+/// pointer, and the writer waits until the slot it's going to modify has no readers. Readers never wait for the writer.
+template<typename T>
+class PublishedSharedPtr {
+public:
+    explicit PublishedSharedPtr(std::shared_ptr<T> value)
+    {
+        slots_[0] = std::move(value);
+    }
+
+    std::shared_ptr<T> load() const
+    {
+        while (true) {
+            const auto slotIndex = currentSlotIndex_.load();
+            readerCounters_[slotIndex].fetch_add(1);
+            if (currentSlotIndex_.load() != slotIndex) {
+                readerCounters_[slotIndex].fetch_sub(1);
+                continue;
+            }
+            auto result = slots_[slotIndex];
+            readerCounters_[slotIndex].fetch_sub(1);
+            return result;
+        }
+    }
+
+    void store(std::shared_ptr<T> value)
+    {
+        auto lock = std::lock_guard{writerMutex_};
+        const auto prevSlotIndex = currentSlotIndex_.load();
+        const auto nextSlotIndex = 1 - prevSlotIndex;
+        waitForReaders(nextSlotIndex);
+        slots_[nextSlotIndex] = std::move(value);
+        currentSlotIndex_.store(nextSlotIndex);
+
+        waitForReaders(prevSlotIndex);
+        slots_[prevSlotIndex].reset();
+    }
+
+private:
+    void waitForReaders(std::size_t slotIndex) const
+    {
+        while (readerCounters_[slotIndex].load() != 0)
+            std::this_thread::yield();
+    }
+
+private:
+    std::array<std::shared_ptr<T>, 2> slots_;
+    mutable std::array<std::atomic<std::size_t>, 2> readerCounters_ = {};
+    std::atomic<std::size_t> currentSlotIndex_ = 0;
+    std::mutex writerMutex_;
+};
+
+} // namespace whaleroute::detail
+
+namespace whaleroute {
+
+/// Router handle, which allows replacing the set of routes at runtime.
+/// Request processing doesn't lock and can be performed from any number of threads concurrently with the publication
+/// of new routes. Request processor queues created before the publication continue to use the previous routes.
+template<typename TRequest, typename TResponse, typename TResponseConverter = _, typename TRouteContext = _>
+class RequestRouterHandle {
+    using Router = RequestRouter<TRequest, TResponse, TResponseConverter, TRouteContext>;
+    using FrozenRouter = FrozenRequestRouter<TRequest, TResponse, TResponseConverter, TRouteContext>;
+
+public:
+    explicit RequestRouterHandle(FrozenRouter router)
+        : router_{std::make_shared<const FrozenRouter>(std::move(router))}
+    {
+    }
+
+    template<typename TRouter, std::enable_if_t<std::is_base_of_v<Router, TRouter>>* = nullptr>
+    explicit RequestRouterHandle(std::shared_ptr<TRouter> router)
+        : RequestRouterHandle{freeze(std::move(router))}
+    {
+    }
+
+    /// Replaces the routes with the ones from the frozen router.
+    /// The RequestRouter object must outlive the request processor queues created from it.
+    void publish(FrozenRouter router)
+    {
+        router_.store(std::make_shared<const FrozenRouter>(std::move(router)));
+    }
+
+    /// Replaces the routes with the ones currently registered in the router.
+    /// The router object is kept alive until all request processor queues that use its routes are destroyed.
+    template<typename TRouter, std::enable_if_t<std::is_base_of_v<Router, TRouter>>* = nullptr>
+    void publish(std::shared_ptr<TRouter> router)
+    {
+        publish(freeze(std::move(router)));
+    }
+
+    void process(const TRequest& request, TResponse& response) const
+    {
+        auto queue = makeRequestProcessorQueue(request, response);
+        queue.launch();
+    }
+
+    RequestProcessorQueue makeRequestProcessorQueue(const TRequest& request, TResponse& response) const
+    {
+        return router_.load()->makeRequestProcessorQueue(request, response);
+    }
+
+    template<typename TExecutor, std::enable_if_t<detail::IsExecutor<TExecutor>::value>* = nullptr>
+    void process(const TRequest& request, TResponse& response, TExecutor& executor) const
+    {
+        auto queue = makeRequestProcessorQueue(request, response, executor);
+        queue.launch();
+    }
+
+    template<typename TExecutor, std::enable_if_t<detail::IsExecutor<TExecutor>::value>* = nullptr>
+    RequestProcessorQueue makeRequestProcessorQueue(const TRequest& request, TResponse& response, TExecutor& executor)
+            const
+    {
+        return router_.load()->makeRequestProcessorQueue(request, response, executor);
+    }
+
+    /// All requests of the batch are processed with the same routes.
+    void process(const std::vector<TRequest>& requests, std::vector<TResponse>& responses) const
+    {
+        for (auto& queue : makeRequestProcessorQueues(requests, responses))
+            queue.launch();
+    }
+
+    std::vector<RequestProcessorQueue> makeRequestProcessorQueues(
+            const std::vector<TRequest>& requests,
+            std::vector<TResponse>& responses) const
+    {
+        return router_.load()->makeRequestProcessorQueues(requests, responses);
+    }
+
+private:
+    template<typename TRouter>
+    static FrozenRouter freeze(std::shared_ptr<TRouter> router)
+    {
+        auto& baseRouter = static_cast<Router&>(*router);
+        return baseRouter.makeFrozenRouter(std::move(router));
+    }
+
+private:
+    detail::PublishedSharedPtr<const FrozenRouter> router_;
+};
+
+} // namespace whaleroute
+
+#endif // WHALEROUTE_REQUESTROUTERHANDLE_H
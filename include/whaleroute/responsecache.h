@@ -0,0 +1,132 @@
+#ifndef WHALEROUTE_RESPONSECACHE_H
+#define WHALEROUTE_RESPONSECACHE_H
+
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace whaleroute {
+
+struct ResponseCachePolicy {
+    /// Maximum number of the cached responses of a request processor, the least recently used ones are evicted first
+    std::size_t maxSize = 1024;
+    std::chrono::steady_clock::duration timeToLive = std::chrono::steady_clock::duration::max();
+    /// Number of the independently locked parts of the cache
+    std::size_t shardCount = 16;
+};
+
+} // namespace whaleroute
+
+namespace whaleroute::detail {
+
+struct ResponseCacheKey {
+    std::string value;
+    std::size_t hash = 0;
+};
+
+// Parameters are prefixed with their sizes, so that different parameter lists can't produce the same key
+inline ResponseCacheKey makeResponseCacheKey(const std::vector<std::string>& routeParams)
+{
+    auto key = ResponseCacheKey{};
+    for (const auto& param : routeParams) {
+        key.value += std::to_string(param.size());
+        key.value += ':';
+        key.value += param;
+    }
+    key.hash = std::hash<std::string>{}(key.value);
+    return key;
+}
+
+/// Stores the responses of a request processor by the values of the route parameters.
+/// Entries are split between shards with separate locks, each shard evicts its least recently used entries.
+template<typename TValue>
+class ResponseCache {
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const TValue> value;
+        Clock::time_point expirationTime;
+    };
+
+    struct alignas(cacheLineSize) Shard {
+        std::mutex mutex;
+        // The most recently used entries are at the front
+        std::list<Entry> entries;
+        std::unordered_map<std::string_view, typename std::list<Entry>::iterator> entryIndex;
+    };
+
+public:
+    explicit ResponseCache(const ResponseCachePolicy& policy)
+        : timeToLive_{policy.timeToLive}
+        , shardCount_{std::clamp<std::size_t>(policy.shardCount, 1, std::max<std::size_t>(policy.maxSize, 1))}
+        , maxShardSize_{(policy.maxSize + shardCount_ - 1) / shardCount_}
+        , shards_{std::make_unique<Shard[]>(shardCount_)}
+    {
+    }
+
+    std::shared_ptr<const TValue> find(const ResponseCacheKey& key)
+    {
+        auto& shard = shards_[key.hash % shardCount_];
+        auto lock = std::lock_guard{shard.mutex};
+        auto it = shard.entryIndex.find(key.value);
+        if (it == shard.entryIndex.end())
+            return nullptr;
+
+        const auto entryIt = it->second;
+        if (entryIt->expirationTime <= Clock::now()) {
+            shard.entryIndex.erase(it);
+            shard.entries.erase(entryIt);
+            return nullptr;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, entryIt);
+        return entryIt->value;
+    }
+
+    std::shared_ptr<const TValue> insert(const ResponseCacheKey& key, TValue value)
+    {
+        auto cachedValue = std::make_shared<const TValue>(std::move(value));
+        if (!maxShardSize_)
+            return cachedValue;
+
+        const auto expirationTime = timeToLive_ == Clock::duration::max() ? Clock::time_point::max()
+                                                                          : Clock::now() + timeToLive_;
+        auto& shard = shards_[key.hash % shardCount_];
+        auto lock = std::lock_guard{shard.mutex};
+        // The response can be added by another thread processing the same route parameters
+        if (auto it = shard.entryIndex.find(key.value); it != shard.entryIndex.end()) {
+            it->second->value = cachedValue;
+            it->second->expirationTime = expirationTime;
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return cachedValue;
+        }
+
+        shard.entries.push_front(Entry{key.value, cachedValue, expirationTime});
+        shard.entryIndex.emplace(shard.entries.front().key, shard.entries.begin());
+        if (shard.entries.size() > maxShardSize_) {
+            shard.entryIndex.erase(shard.entries.back().key);
+            shard.entries.pop_back();
+        }
+        return cachedValue;
+    }
+
+private:
+    Clock::duration timeToLive_;
+    std::size_t shardCount_;
+    std::size_t maxShardSize_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+} // namespace whaleroute::detail
+
+#endif // WHALEROUTE_RESPONSECACHE_H
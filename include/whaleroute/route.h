@@ -2,14 +2,20 @@
 #define WHALEROUTE_ROUTE_H
 
 #include "irequestrouter.h"
+#include "perthreadinstance.h"
 #include "requestprocessor.h"
+#include "responsecache.h"
 #include "routematcherinvoker.h"
+#include "routestatistics.h"
 #include "types.h"
 #include "utils.h"
 #include "external/sfun/interface.h"
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace whaleroute {
@@ -21,8 +27,7 @@ namespace whaleroute::detail {
 
 template<typename TRequest, typename TResponse, typename TResponseConverter, typename TRouteContext>
 class Route {
-    using ProcessorFunc =
-            std::function<void(const TRequest&, TResponse&, const std::vector<std::string>&, TRouteContext&)>;
+    using ProcessorFunc = RequestProcessorFunc<TRequest, TResponse, TRouteContext>;
     using Router = RequestRouter<TRequest, TResponse, TResponseConverter, TRouteContext>;
     friend Router;
 
@@ -36,139 +41,322 @@ public:
 
     template<typename TProcessor, typename... TArgs>
     auto process(TArgs&&... args) -> std::enable_if_t<std::is_constructible_v<TProcessor, TArgs...>, Route&>
+    {
+        addRequestProcessor(makeRequestProcessor<TProcessor>(std::forward<TArgs>(args)...));
+        return *this;
+    }
+
+    /// Registers a processor that is created separately for each thread processing the route's requests.
+    /// This allows using processors with mutable state without synchronization.
+    /// Objects are created lazily with copies of the passed arguments, use std::ref to pass a reference.
+    template<typename TProcessor, typename... TArgs>
+    auto processPerThread(TArgs&&... args)
+            -> std::enable_if_t<std::is_constructible_v<TProcessor, const UnwrapRefDecay<TArgs>&...>, Route&>
+    {
+        using RequestProcessor = PerThreadInstance<TProcessor>;
+        auto responseCache = makeResponseCache<TProcessor>();
+        auto requestProcessor = std::make_shared<RequestProcessor>(
+                [args = std::make_tuple(std::forward<TArgs>(args)...)]
+                {
+                    return std::apply(
+                            [](auto&&... arg)
+                            {
+                                return std::make_unique<typename RequestProcessor::Instance>(arg...);
+                            },
+                            args);
+                });
+        addRequestProcessor(
+                [requestProcessor, responseCache, this]( //
+                        const TRequest& request,
+                        TResponse& response,
+                        const std::vector<std::string>& routeParams,
+                        TRouteContext& routeContext)
+                {
+                    return invokeRequestProcessor<TResponseConverter>(
+                            requestProcessor->get(),
+                            request,
+                            response,
+                            routeParams,
+                            routeContext,
+                            routeParameterErrorHandler_,
+                            responseCache.get());
+                });
+        return *this;
+    }
+
+    template<typename TProcessor>
+    Route& process(TProcessor&& requestProcessor)
+    {
+        addRequestProcessor(wrapRequestProcessor(std::forward<TProcessor>(requestProcessor)));
+        return *this;
+    }
+
+    /// Registers a processor that is invoked on the executor passed to RequestRouter::makeRequestProcessorQueue,
+    /// so that expensive processing doesn't block the calling thread. Route matchers are still checked on the calling
+    /// thread, and the following processors are invoked automatically on completion. Without an executor, it's inline.
+    template<typename TProcessor, typename... TArgs>
+    auto processOffloaded(TArgs&&... args)
+            -> std::enable_if_t<std::is_constructible_v<TProcessor, TArgs...>, Route&>
+    {
+        auto requestProcessor = makeRequestProcessor<TProcessor>(std::forward<TArgs>(args)...);
+        addRequestProcessor(makeOffloadedRequestProcessor(std::move(requestProcessor)));
+        return *this;
+    }
+
+    template<typename TProcessor>
+    Route& processOffloaded(TProcessor&& requestProcessor)
+    {
+        auto processor = wrapRequestProcessor(std::forward<TProcessor>(requestProcessor));
+        addRequestProcessor(makeOffloadedRequestProcessor(std::move(processor)));
+        return *this;
+    }
+
+    /// Caches the responses of the processors registered after the call by the values of the route parameters.
+    /// Only the processors returning values are cached, their results must depend only on the route parameters.
+    template<
+            typename TCheckResponseConverter = TResponseConverter,
+            typename = std::enable_if_t<!std::is_same_v<TCheckResponseConverter, _>>>
+    Route& cache(ResponseCachePolicy policy = {})
+    {
+        responseCachePolicy_ = policy;
+        return *this;
+    }
+
+    /// Sets the response with TResponseConverter. If the converter has the render(const TArgs&...) method, the values
+    /// are rendered once and the result is passed to the converter for each request instead.
+    template<
+            typename... TArgs,
+            typename TCheckResponseConverter = TResponseConverter,
+            typename = std::enable_if_t<!std::is_same_v<TCheckResponseConverter, _>>>
+    void set(TArgs&&... args)
+    {
+        if constexpr (HasResponseRendering<TResponseConverter, std::tuple<std::decay_t<TArgs>...>>::value)
+            addRequestProcessor(
+                    [rendered = TResponseConverter{}.render(std::as_const(args)...)]( //
+                            const TRequest&,
+                            TResponse& response,
+                            const std::vector<std::string>&,
+                            TRouteContext&)
+                    {
+                        TResponseConverter{}(response, rendered);
+                        return AsyncOperation{};
+                    });
+        else
+            addRequestProcessor(
+                    [=]( //
+                            const TRequest&,
+                            TResponse& response,
+                            const std::vector<std::string>&,
+                            TRouteContext&)
+                    {
+                        TResponseConverter{}(response, args...);
+                        return AsyncOperation{};
+                    });
+    }
+
+private:
+    const std::vector<ProcessorFunc>& getRequestProcessors() const
+    {
+        return processorList_;
+    }
+
+    // Route matchers are applied to the processors registered after the call
+    void setRouteMatchers(std::vector<RouteMatcherInvoker<TRequest, TRouteContext>> routeMatchers)
+    {
+        routeMatchers_ = std::move(routeMatchers);
+    }
+
+    bool hasRouteMatchers() const
+    {
+        return !routeMatchers_.empty();
+    }
+
+    RouteCounters* counters() const
+    {
+        return counters_.get();
+    }
+
+    RouteCounters& enableCounters(RouteStatisticsLevel level)
+    {
+        if (counters_) {
+            if (level == RouteStatisticsLevel::LatencyHistograms)
+                counters_->enableLatencyHistograms(processorList_.size());
+            return *counters_;
+        }
+
+        counters_ = std::make_unique<RouteCounters>();
+        if (level == RouteStatisticsLevel::LatencyHistograms)
+            counters_->enableLatencyHistograms(processorList_.size());
+        routeParameterErrorHandler_ =
+                [counters = counters_.get(), errorHandler = std::move(routeParameterErrorHandler_)](
+                        const TRequest& request,
+                        TResponse& response,
+                        const RouteParameterError& error)
+        {
+            counters->addRouteParameterError();
+            errorHandler(request, response, error);
+        };
+        return *counters_;
+    }
+
+    template<typename TProcessor, typename... TArgs>
+    ProcessorFunc makeRequestProcessor(TArgs&&... args)
     {
         if constexpr (std::is_copy_constructible_v<TProcessor>) {
             auto requestProcessor = TProcessor{std::forward<TArgs>(args)...};
-            processorList_.emplace_back(
-                    [requestProcessor, this](
+            return ProcessorFunc{
+                    [requestProcessor, responseCache = makeResponseCache<TProcessor>(), this](
                             const TRequest& request,
                             TResponse& response,
                             const std::vector<std::string>& routeParams,
                             TRouteContext& routeContext) mutable
                     {
-                        invokeRequestProcessor<TResponseConverter>(
+                        return invokeRequestProcessor<TResponseConverter>(
                                 requestProcessor,
                                 request,
                                 response,
                                 routeParams,
                                 routeContext,
-                                routeParameterErrorHandler_);
-                    });
+                                routeParameterErrorHandler_,
+                                responseCache.get());
+                    }};
         }
         else {
             auto requestProcessor = std::make_shared<TProcessor>(std::forward<TArgs>(args)...);
-            processorList_.emplace_back(
-                    [requestProcessor, this]( //
+            return ProcessorFunc{
+                    [requestProcessor, responseCache = makeResponseCache<TProcessor>(), this]( //
                             const TRequest& request,
                             TResponse& response,
                             const std::vector<std::string>& routeParams,
                             TRouteContext& routeContext)
                     {
-                        invokeRequestProcessor<TResponseConverter>(
+                        return invokeRequestProcessor<TResponseConverter>(
                                 *requestProcessor,
                                 request,
                                 response,
                                 routeParams,
                                 routeContext,
-                                routeParameterErrorHandler_);
-                    });
+                                routeParameterErrorHandler_,
+                                responseCache.get());
+                    }};
         }
-        return *this;
     }
 
     template<typename TProcessor>
-    Route& process(TProcessor&& requestProcessor)
+    ProcessorFunc wrapRequestProcessor(TProcessor&& requestProcessor)
     {
         if constexpr (std::is_lvalue_reference_v<decltype(requestProcessor)>) {
-            processorList_.emplace_back(
-                    [&requestProcessor, this]( //
+            return ProcessorFunc{
+                    [&requestProcessor, responseCache = makeResponseCache<std::decay_t<TProcessor>>(), this]( //
                             const TRequest& request,
                             TResponse& response,
                             const std::vector<std::string>& routeParams,
                             TRouteContext& routeContext)
                     {
-                        invokeRequestProcessor<TResponseConverter>(
+                        return invokeRequestProcessor<TResponseConverter>(
                                 requestProcessor,
                                 request,
                                 response,
                                 routeParams,
                                 routeContext,
-                                routeParameterErrorHandler_);
-                    });
+                                routeParameterErrorHandler_,
+                                responseCache.get());
+                    }};
         }
         else {
-            processorList_.emplace_back(
-                    [requestProcessor = std::forward<TProcessor>(requestProcessor), this]( //
+            return ProcessorFunc{
+                    [requestProcessor = std::forward<TProcessor>(requestProcessor),
+                     responseCache = makeResponseCache<std::decay_t<TProcessor>>(),
+                     this]( //
                             const TRequest& request,
                             TResponse& response,
                             const std::vector<std::string>& routeParams,
                             TRouteContext& routeContext)
                     {
-                        invokeRequestProcessor<TResponseConverter>(
+                        return invokeRequestProcessor<TResponseConverter>(
                                 requestProcessor,
                                 request,
                                 response,
                                 routeParams,
                                 routeContext,
-                                routeParameterErrorHandler_);
-                    });
+                                routeParameterErrorHandler_,
+                                responseCache.get());
+                    }};
         }
-        return *this;
     }
 
-    template<
-            typename... TArgs,
-            typename TCheckResponseConverter = TResponseConverter,
-            typename = std::enable_if_t<!std::is_same_v<TCheckResponseConverter, _>>>
-    void set(TArgs&&... args)
+    template<typename TProcessor>
+    auto makeResponseCache() const
     {
-        processorList_.emplace_back(
-                [=]( //
-                        const TRequest&,
-                        TResponse& response,
-                        const std::vector<std::string>&,
-                        TRouteContext&) mutable
-                {
-                    TResponseConverter{}(response, std::forward<TArgs>(args)...);
-                });
+        using ResponseCache = typename ResponseCacheFor<TResponseConverter, TProcessor>::type;
+        auto responseCache = std::shared_ptr<ResponseCache>{};
+        if constexpr (!std::is_same_v<ResponseCache, NoResponseCache>)
+            if (responseCachePolicy_)
+                responseCache = std::make_shared<ResponseCache>(*responseCachePolicy_);
+        return responseCache;
     }
 
-private:
-    std::vector<ProcessorFunc> getRequestProcessors() const
+    static ProcessorFunc makeOffloadedRequestProcessor(ProcessorFunc processor)
     {
-        auto toMatchedProcessorFunc = [&](const ProcessorFunc& processor) -> ProcessorFunc
+        return [processor = std::move(processor)](
+                       const TRequest& request,
+                       TResponse& response,
+                       const std::vector<std::string>& routeParams,
+                       TRouteContext& routeContext) -> AsyncOperation
         {
-            return [this, &processor](
-                           const TRequest& request,
-                           TResponse& response,
-                           const std::vector<std::string>& routeParams,
-                           TRouteContext& routeContext)
+            return [&](const Executor& executor, std::function<void()> onCompleted)
             {
-                if (!std::all_of(
-                            routeMatchers_.begin(),
-                            routeMatchers_.end(),
-                            [&request, &routeContext](auto& routeMatcher) -> bool
-                            {
-                                return routeMatcher(request, routeContext);
-                            }))
-                    return;
-                processor(request, response, routeParams, routeContext);
+                auto invokeProcessor = [&, onCompleted = std::move(onCompleted)]
+                {
+                    auto asyncOperation = processor(request, response, routeParams, routeContext);
+                    if (asyncOperation)
+                        asyncOperation(executor, onCompleted);
+                    else
+                        onCompleted();
+                };
+                if (executor)
+                    executor(std::move(invokeProcessor));
+                else
+                    invokeProcessor();
             };
         };
+    }
+
+    void addRequestProcessor(ProcessorFunc processor)
+    {
+        if (counters_)
+            counters_->addProcessorLatency();
 
-        auto result = std::vector<ProcessorFunc>{};
-        std::transform(
-                processorList_.begin(),
-                processorList_.end(),
-                std::back_inserter(result),
-                toMatchedProcessorFunc);
-        return result;
+        if (routeMatchers_.empty()) {
+            processorList_.emplace_back(std::move(processor));
+            return;
+        }
+
+        processorList_.emplace_back(
+                [this, processor = std::move(processor)](
+                        const TRequest& request,
+                        TResponse& response,
+                        const std::vector<std::string>& routeParams,
+                        TRouteContext& routeContext) -> AsyncOperation
+                {
+                    if (!std::all_of(
+                                routeMatchers_.begin(),
+                                routeMatchers_.end(),
+                                [&request, &routeContext](auto& routeMatcher) -> bool
+                                {
+                                    return routeMatcher(request, routeContext);
+                                }))
+                        return {};
+                    return processor(request, response, routeParams, routeContext);
+                });
     }
 
 private:
     std::vector<ProcessorFunc> processorList_;
     std::vector<RouteMatcherInvoker<TRequest, TRouteContext>> routeMatchers_;
     std::function<void(const TRequest&, TResponse&, const RouteParameterError&)> routeParameterErrorHandler_;
+    std::unique_ptr<RouteCounters> counters_;
+    std::optional<ResponseCachePolicy> responseCachePolicy_;
 };
 
 } // namespace whaleroute::detail
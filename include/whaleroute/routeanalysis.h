@@ -0,0 +1,256 @@
+#ifndef WHALEROUTE_ROUTEANALYSIS_H
+#define WHALEROUTE_ROUTEANALYSIS_H
+
+#include "lazyregex.h"
+#include "types.h"
+#include "utils.h"
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace whaleroute {
+
+struct ShadowedRoute {
+    std::size_t routeIndex;
+    std::string route;
+    /// The earliest route without route matchers that matches all request paths of the shadowed route.
+    /// The shadowed route is reached only if the processing isn't finished by the processors of this route.
+    std::size_t shadowingRouteIndex;
+    std::string shadowingRoute;
+};
+
+enum class RegexRouteKind {
+    /// Pattern without special characters, it can be registered as a path route
+    Literal,
+    /// Pattern consisting of literal segments and captures of whole segments like ([^/]+) or (\d+)
+    SegmentTemplate
+};
+
+struct SimplifiableRegexRoute {
+    std::size_t routeIndex;
+    std::string pattern;
+    RegexRouteKind kind;
+    /// Path matched by a literal pattern, empty for segment templates
+    std::string path;
+};
+
+struct DuplicateRegexRoutes {
+    std::string pattern;
+    std::vector<std::size_t> routeIndices;
+};
+
+struct RouteTableAnalysis {
+    std::vector<ShadowedRoute> shadowedRoutes;
+    std::vector<SimplifiableRegexRoute> simplifiableRegexRoutes;
+    std::vector<DuplicateRegexRoutes> duplicateRegexRoutes;
+    /// Estimated number of comparisons performed to match a request path in the worst case:
+    /// one lookup in the path index and one match of each distinct regular expression
+    std::size_t worstCaseComparisons = 0;
+};
+
+} // namespace whaleroute
+
+namespace whaleroute::detail {
+
+inline bool isWholeSegmentCapture(std::string_view groupPattern)
+{
+    static const auto segmentPatterns = std::vector<std::string_view>{
+            "[^/]+",
+            "[^/]*",
+            R"(\d+)",
+            R"(\d*)",
+            R"(\w+)",
+            R"(\w*)",
+            "[0-9]+",
+            "[0-9]*",
+            "[a-z]+",
+            "[A-Za-z]+",
+            "[a-zA-Z]+",
+            "[a-zA-Z0-9]+",
+            "[a-zA-Z0-9_-]+"};
+    return std::find(segmentPatterns.begin(), segmentPatterns.end(), groupPattern) != segmentPatterns.end();
+}
+
+struct SimplifiedRegex {
+    RegexRouteKind kind;
+    std::string path;
+};
+
+// Returns the kind of the regular expression if it can be replaced with a path route or a simpler route template
+inline std::optional<SimplifiedRegex> simplifyRegex(std::string_view pattern)
+{
+    auto path = std::string{};
+    auto hasCaptures = false;
+    for (auto i = std::size_t{}; i < pattern.size(); ++i) {
+        const auto ch = pattern[i];
+        if (ch == '\\') {
+            if (i + 1 == pattern.size() || std::isalnum(static_cast<unsigned char>(pattern[i + 1])))
+                return std::nullopt;
+            path += pattern[++i];
+        }
+        else if (ch == '(') {
+            const auto groupEnd = pattern.find(')', i);
+            if (groupEnd == std::string_view::npos)
+                return std::nullopt;
+            const auto groupPattern = pattern.substr(i + 1, groupEnd - i - 1);
+            const auto isSegmentStart = i > 0 && pattern[i - 1] == '/';
+            const auto isSegmentEnd = groupEnd + 1 == pattern.size() || pattern[groupEnd + 1] == '/';
+            if (!isSegmentStart || !isSegmentEnd || !isWholeSegmentCapture(groupPattern))
+                return std::nullopt;
+            hasCaptures = true;
+            i = groupEnd;
+        }
+        else if (isRegexSpecialCharacter(ch))
+            return std::nullopt;
+        else
+            path += ch;
+    }
+    if (hasCaptures)
+        return SimplifiedRegex{RegexRouteKind::SegmentTemplate, {}};
+    return SimplifiedRegex{RegexRouteKind::Literal, std::move(path)};
+}
+
+/// Collects the RouteTableAnalysis from the routes added in the order of their registration
+class RouteTableAnalyzer {
+    struct ShadowingRegexRoute {
+        std::size_t routeIndex;
+        const LazyRegex* regExp;
+    };
+
+    struct ShadowingCatchAllRoute {
+        std::size_t routeIndex;
+        std::string prefix;
+    };
+
+public:
+    explicit RouteTableAnalyzer(TrailingSlashMode trailingSlashMode)
+        : trailingSlashMode_{trailingSlashMode}
+    {
+    }
+
+    // Routes with route matchers or without processors can't shadow other routes
+    void addPathRoute(const std::string& path, bool canShadowRoutes)
+    {
+        const auto routeIndex = addRoute(path, canShadowRoutes);
+        hasPathRoutes_ = true;
+        if (const auto catchAllPrefix = catchAllRoutePrefix(path)) {
+            auto prefix = std::string{*catchAllPrefix};
+            if (const auto shadowingRouteIndex = findShadowingCatchAllRoute(prefix))
+                addShadowedRoute(routeIndex, *shadowingRouteIndex);
+            if (canShadowRoutes)
+                shadowingCatchAllRoutes_.push_back({routeIndex, std::move(prefix)});
+            return;
+        }
+        checkShadowing(routeIndex, path);
+        if (canShadowRoutes)
+            shadowingPathRoutes_.emplace(path, routeIndex);
+    }
+
+    void addRegexRoute(const std::string& pattern, const LazyRegex& regExp, bool canShadowRoutes)
+    {
+        const auto routeIndex = addRoute(pattern, canShadowRoutes);
+        regexes_.insert(&regExp);
+        auto [duplicateIt, isNewPattern] = duplicateRegexIndices_.emplace(pattern, duplicateRegexRoutes_.size());
+        if (isNewPattern)
+            duplicateRegexRoutes_.push_back({pattern, {}});
+        duplicateRegexRoutes_[duplicateIt->second].routeIndices.push_back(routeIndex);
+
+        auto simplifiedRegex = simplifyRegex(pattern);
+        if (simplifiedRegex && simplifiedRegex->kind == RegexRouteKind::Literal)
+            checkShadowing(routeIndex, makePath(simplifiedRegex->path, trailingSlashMode_));
+        else
+            checkShadowingByDuplicate(routeIndex, duplicateRegexRoutes_[duplicateIt->second].routeIndices);
+        if (simplifiedRegex)
+            analysis_.simplifiableRegexRoutes.push_back(
+                    {routeIndex, pattern, simplifiedRegex->kind, std::move(simplifiedRegex->path)});
+
+        if (canShadowRoutes)
+            shadowingRegexRoutes_.push_back({routeIndex, &regExp});
+    }
+
+    RouteTableAnalysis result() const
+    {
+        auto result = analysis_;
+        for (const auto& duplicateRegexRoutes : duplicateRegexRoutes_)
+            if (duplicateRegexRoutes.routeIndices.size() > 1)
+                result.duplicateRegexRoutes.push_back(duplicateRegexRoutes);
+        result.worstCaseComparisons = (hasPathRoutes_ ? 1 : 0) + regexes_.size();
+        return result;
+    }
+
+private:
+    std::size_t addRoute(const std::string& route, bool canShadowRoutes)
+    {
+        routes_.push_back(route);
+        canShadowRoutes_.push_back(canShadowRoutes);
+        return routes_.size() - 1;
+    }
+
+    void checkShadowing(std::size_t routeIndex, const std::string& path)
+    {
+        auto shadowingRouteIndex = findShadowingCatchAllRoute(path);
+        if (auto it = shadowingPathRoutes_.find(path);
+            it != shadowingPathRoutes_.end() && (!shadowingRouteIndex || it->second < *shadowingRouteIndex))
+            shadowingRouteIndex = it->second;
+        for (const auto& regexRoute : shadowingRegexRoutes_) {
+            if (shadowingRouteIndex && *shadowingRouteIndex < regexRoute.routeIndex)
+                break;
+            if (std::regex_match(path, regexRoute.regExp->get())) {
+                shadowingRouteIndex = regexRoute.routeIndex;
+                break;
+            }
+        }
+        if (shadowingRouteIndex)
+            addShadowedRoute(routeIndex, *shadowingRouteIndex);
+    }
+
+    // Returns the earliest catch-all route matching the path
+    std::optional<std::size_t> findShadowingCatchAllRoute(const std::string& path) const
+    {
+        for (const auto& catchAllRoute : shadowingCatchAllRoutes_) {
+            const auto& prefix = catchAllRoute.prefix;
+            const auto isPrefix = path.compare(0, prefix.size(), prefix) == 0;
+            if (isPrefix && (path.size() == prefix.size() || path[prefix.size()] == '/'))
+                return catchAllRoute.routeIndex;
+        }
+        return std::nullopt;
+    }
+
+    void checkShadowingByDuplicate(std::size_t routeIndex, const std::vector<std::size_t>& duplicateRouteIndices)
+    {
+        for (auto duplicateRouteIndex : duplicateRouteIndices)
+            if (duplicateRouteIndex != routeIndex && canShadowRoutes_[duplicateRouteIndex]) {
+                addShadowedRoute(routeIndex, duplicateRouteIndex);
+                return;
+            }
+    }
+
+    void addShadowedRoute(std::size_t routeIndex, std::size_t shadowingRouteIndex)
+    {
+        analysis_.shadowedRoutes.push_back(
+                {routeIndex, routes_[routeIndex], shadowingRouteIndex, routes_[shadowingRouteIndex]});
+    }
+
+private:
+    TrailingSlashMode trailingSlashMode_;
+    RouteTableAnalysis analysis_;
+    std::vector<std::string> routes_;
+    std::vector<bool> canShadowRoutes_;
+    std::unordered_map<std::string, std::size_t> shadowingPathRoutes_;
+    std::vector<ShadowingRegexRoute> shadowingRegexRoutes_;
+    std::vector<ShadowingCatchAllRoute> shadowingCatchAllRoutes_;
+    std::unordered_map<std::string, std::size_t> duplicateRegexIndices_;
+    std::vector<DuplicateRegexRoutes> duplicateRegexRoutes_;
+    bool hasPathRoutes_ = false;
+    std::unordered_set<const LazyRegex*> regexes_;
+};
+
+} // namespace whaleroute::detail
+
+#endif // WHALEROUTE_ROUTEANALYSIS_H
@@ -0,0 +1,80 @@
+#ifndef WHALEROUTE_ROUTECONTEXTPOOL_H
+#define WHALEROUTE_ROUTECONTEXTPOOL_H
+
+#include "perthreadinstance.h"
+#include "utils.h"
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace whaleroute::config {
+/// Specialize to clear the pooled route contexts before they're reused by another request:
+///   void operator()(TRouteContext&) const;
+/// Without a specialization, contexts are reset by assigning a default constructed object, which frees their buffers.
+template<typename TRouteContext>
+struct RouteContextReset;
+
+} // namespace whaleroute::config
+
+namespace whaleroute::detail {
+
+template<typename TRouteContext>
+inline constexpr bool isPoolableRouteContext =
+        std::is_move_constructible_v<TRouteContext> && std::is_move_assignable_v<TRouteContext>;
+
+template<typename TRouteContext>
+void resetRouteContext(TRouteContext& routeContext)
+{
+    if constexpr (IsCompleteType<config::RouteContextReset<TRouteContext>>::value)
+        config::RouteContextReset<TRouteContext>{}(routeContext);
+    else
+        routeContext = TRouteContext{};
+}
+
+/// Keeps the route contexts of the processed requests for reuse along with their allocated capacity.
+/// Each thread has its own list of free contexts, so acquiring and releasing them doesn't lock.
+template<typename TRouteContext>
+class RouteContextPool {
+    using FreeContextList = PerThreadInstance<std::vector<TRouteContext>>;
+
+public:
+    explicit RouteContextPool(std::size_t maxSizePerThread)
+        : maxSizePerThread_{maxSizePerThread}
+        , freeContexts_{[]
+                        {
+                            return std::make_unique<typename FreeContextList::Instance>();
+                        }}
+    {
+    }
+
+    TRouteContext acquire()
+    {
+        auto& freeContexts = freeContexts_.get();
+        if (freeContexts.empty())
+            return TRouteContext{};
+        auto routeContext = std::move(freeContexts.back());
+        freeContexts.pop_back();
+        return routeContext;
+    }
+
+    void release(TRouteContext& routeContext)
+    {
+        auto& freeContexts = freeContexts_.get();
+        if (freeContexts.size() >= maxSizePerThread_)
+            return;
+        resetRouteContext(routeContext);
+        if (freeContexts.capacity() == 0)
+            freeContexts.reserve(maxSizePerThread_);
+        freeContexts.push_back(std::move(routeContext));
+    }
+
+private:
+    std::size_t maxSizePerThread_;
+    FreeContextList freeContexts_;
+};
+
+} // namespace whaleroute::detail
+
+#endif // WHALEROUTE_ROUTECONTEXTPOOL_H
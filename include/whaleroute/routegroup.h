@@ -0,0 +1,130 @@
+#ifndef WHALEROUTE_ROUTEGROUP_H
+#define WHALEROUTE_ROUTEGROUP_H
+
+#include "route.h"
+#include "routematcherinvoker.h"
+#include "types.h"
+#include "utils.h"
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace whaleroute {
+template<typename TRequest, typename TResponse, typename TResponseConverter, typename TRouteContext>
+class RequestRouter;
+}
+
+namespace whaleroute::detail {
+
+template<typename TRequest, typename TResponse, typename TResponseConverter, typename TRouteContext>
+class RouteGroup {
+    using Route = detail::Route<TRequest, TResponse, TResponseConverter, TRouteContext>;
+    using Router = RequestRouter<TRequest, TResponse, TResponseConverter, TRouteContext>;
+    using RouteMatcherList = std::vector<RouteMatcherInvoker<TRequest, TRouteContext>>;
+    friend Router;
+
+public:
+    RouteGroup(Router& router, std::size_t index, std::string prefix, RouteMatcherList routeMatchers)
+        : router_{router}
+        , index_{index}
+        , prefix_{makeRouteGroupPrefix(prefix)}
+        , routeMatchers_{std::move(routeMatchers)}
+    {
+    }
+
+    /// Registers the route with the path appended to the group prefix
+    template<typename... TRouteMatcherArgs>
+    Route& route(const std::string& path, TRouteMatcherArgs&&... matcherArgs)
+    {
+        return router_.pathRouteImpl(prefix_ + path, {std::forward<TRouteMatcherArgs>(matcherArgs)...}, index_);
+    }
+
+    Route& route(const std::string& path)
+    {
+        return router_.pathRouteImpl(prefix_ + path, {}, index_);
+    }
+
+    /// Registers the route matching the part of the request path after the group prefix with the regular expression
+    template<typename... TRouteMatcherArgs>
+    Route& route(const rx& regExp, TRouteMatcherArgs&&... matcherArgs)
+    {
+        return router_.regexRouteImpl(regexPattern(regExp), {std::forward<TRouteMatcherArgs>(matcherArgs)...}, index_);
+    }
+
+    Route& route(const rx& regExp)
+    {
+        return router_.regexRouteImpl(regexPattern(regExp), {}, index_);
+    }
+
+    /// Creates a nested group, its routes are matched with both groups' matchers
+    template<typename... TRouteMatcherArgs>
+    RouteGroup& group(const std::string& prefix, TRouteMatcherArgs&&... matcherArgs)
+    {
+        auto routeMatchers = routeMatchers_;
+        (routeMatchers.emplace_back(std::forward<TRouteMatcherArgs>(matcherArgs)), ...);
+        return router_.groupImpl(prefix_ + makeRouteGroupPrefix(prefix), std::move(routeMatchers));
+    }
+
+private:
+    // The group prefix is matched literally, the child expression is wrapped to keep its alternatives after the prefix
+    rx regexPattern(const rx& regExp) const
+    {
+        return rx{escapeRegex(prefix_) + "(?:" + makeRegexPattern(regExp, router_.trailingSlashMode_) + ")"};
+    }
+
+    const std::string& prefix() const
+    {
+        return prefix_;
+    }
+
+    const RouteMatcherList& routeMatchers() const
+    {
+        return routeMatchers_;
+    }
+
+private:
+    Router& router_;
+    std::size_t index_;
+    std::string prefix_;
+    RouteMatcherList routeMatchers_;
+};
+
+// Result of the group matchers shared by the matched routes of the group while processing a request
+template<typename TRequest, typename TRouteContext>
+class RouteGroupMatch {
+    using RouteMatcherList = std::vector<RouteMatcherInvoker<TRequest, TRouteContext>>;
+
+public:
+    explicit RouteGroupMatch(const RouteMatcherList& routeMatchers)
+        : routeMatchers_{routeMatchers}
+    {
+    }
+
+    bool operator()(const TRequest& request, TRouteContext& routeContext)
+    {
+        if (!result_)
+            result_ = std::all_of(
+                    routeMatchers_.begin(),
+                    routeMatchers_.end(),
+                    [&request, &routeContext](auto& routeMatcher) -> bool
+                    {
+                        return routeMatcher(request, routeContext);
+                    });
+        return *result_;
+    }
+
+    const RouteMatcherList& routeMatchers() const
+    {
+        return routeMatchers_;
+    }
+
+private:
+    const RouteMatcherList& routeMatchers_;
+    std::optional<bool> result_;
+};
+
+} // namespace whaleroute::detail
+
+#endif // WHALEROUTE_ROUTEGROUP_H
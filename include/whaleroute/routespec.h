@@ -0,0 +1,40 @@
+#ifndef WHALEROUTE_ROUTESPEC_H
+#define WHALEROUTE_ROUTESPEC_H
+
+#include "route.h"
+#include "routematcherinvoker.h"
+#include "types.h"
+#include <functional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace whaleroute {
+
+/// Description of a route registered with RequestRouter::addRoutes
+template<typename TRequest, typename TResponse, typename TResponseConverter = _, typename TRouteContext = _>
+struct RouteSpec {
+    using Route = detail::Route<TRequest, TResponse, TResponseConverter, TRouteContext>;
+
+    std::variant<std::string, rx> path;
+    std::vector<detail::RouteMatcherInvoker<TRequest, TRouteContext>> matchers = {};
+    /// Registers the processors of the route, e.g. [](Route& route){ route.process<Handler>(); }
+    std::function<void(Route&)> registerProcessors = {};
+};
+
+enum class RouteSpecErrorType {
+    EmptyPath,
+    NoProcessors,
+    /// The route without matchers has the same path or regular expression as an earlier route without matchers
+    DuplicateRoute
+};
+
+struct RouteSpecError {
+    /// Index of the route spec in the registered range
+    std::size_t specIndex;
+    RouteSpecErrorType type;
+};
+
+} // namespace whaleroute
+
+#endif // WHALEROUTE_ROUTESPEC_H
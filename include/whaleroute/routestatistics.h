@@ -0,0 +1,319 @@
+#ifndef WHALEROUTE_ROUTESTATISTICS_H
+#define WHALEROUTE_ROUTESTATISTICS_H
+
+#include "utils.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace whaleroute::detail {
+
+inline constexpr std::size_t latencySubBucketBits = 5;
+inline constexpr std::size_t latencySubBucketCount = std::size_t{1} << latencySubBucketBits;
+inline constexpr std::size_t latencyMaxValueBits = 42;
+inline constexpr std::size_t latencyBucketCount =
+        latencySubBucketCount + (latencyMaxValueBits - latencySubBucketBits) * latencySubBucketCount;
+
+// Log-linear bucketing like in HdrHistogram: each power of two range is split into the same number of sub-buckets,
+// which gives about 3% precision for values up to 2^42 ns
+inline std::size_t latencyBucketIndex(std::uint64_t value)
+{
+    value = std::min(value, (std::uint64_t{1} << latencyMaxValueBits) - 1);
+    if (value < 2 * latencySubBucketCount)
+        return static_cast<std::size_t>(value);
+
+    auto highestBit = std::size_t{};
+    while (value >> (highestBit + 1))
+        ++highestBit;
+    const auto shift = highestBit - latencySubBucketBits;
+    return latencySubBucketCount + shift * latencySubBucketCount +
+            static_cast<std::size_t>(value >> shift) - latencySubBucketCount;
+}
+
+// Returns the highest value of the bucket
+inline std::uint64_t latencyBucketValue(std::size_t bucketIndex)
+{
+    if (bucketIndex < 2 * latencySubBucketCount)
+        return bucketIndex;
+
+    const auto shift = (bucketIndex - latencySubBucketCount) / latencySubBucketCount;
+    const auto subBucket = (bucketIndex - latencySubBucketCount) % latencySubBucketCount + latencySubBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+inline std::size_t threadStripeIndex()
+{
+    static auto nextThreadIndex = std::atomic<std::size_t>{};
+    thread_local const auto index = nextThreadIndex++;
+    return index;
+}
+
+inline std::size_t stripeCount()
+{
+    return std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, 64);
+}
+
+class LatencyRecorder;
+
+} // namespace whaleroute::detail
+
+namespace whaleroute {
+
+/// Snapshot of the recorded latencies
+class LatencyHistogram {
+    friend class detail::LatencyRecorder;
+
+public:
+    std::uint64_t count() const
+    {
+        return count_;
+    }
+
+    /// Returns the latency that isn't exceeded by the specified percentage of the recorded values, e.g. 99.9
+    std::chrono::nanoseconds percentile(double percentage) const
+    {
+        if (!count_)
+            return {};
+
+        const auto rank = static_cast<std::uint64_t>(std::ceil(percentage / 100 * static_cast<double>(count_)));
+        const auto targetCount = std::clamp<std::uint64_t>(rank, 1, count_);
+        auto accumulatedCount = std::uint64_t{};
+        for (auto i = std::size_t{}; i < bucketCounts_.size(); ++i) {
+            accumulatedCount += bucketCounts_[i];
+            if (accumulatedCount >= targetCount)
+                return std::chrono::nanoseconds{detail::latencyBucketValue(i)};
+        }
+        return std::chrono::nanoseconds{detail::latencyBucketValue(bucketCounts_.size() - 1)};
+    }
+
+    void merge(const LatencyHistogram& other)
+    {
+        if (bucketCounts_.empty())
+            bucketCounts_.resize(detail::latencyBucketCount);
+        for (auto i = std::size_t{}; i < other.bucketCounts_.size(); ++i)
+            bucketCounts_[i] += other.bucketCounts_[i];
+        count_ += other.count_;
+    }
+
+private:
+    std::vector<std::uint64_t> bucketCounts_;
+    std::uint64_t count_ = 0;
+};
+
+struct RouteStatistics {
+    /// Index of the route in the order of registration
+    std::size_t routeIndex;
+    /// Path or regular expression of the route
+    std::string route;
+    std::uint64_t matchCount;
+    std::uint64_t invocationCount;
+    std::uint64_t routeParameterErrorCount;
+    /// Accumulated time from the invocation of the route's processors until their completion
+    std::chrono::nanoseconds processingTime;
+    /// Latencies of the route processing and of each route processor,
+    /// collected with RouteStatisticsLevel::LatencyHistograms
+    LatencyHistogram latency = {};
+    std::vector<LatencyHistogram> processorLatencies = {};
+};
+
+enum class RouteStatisticsLevel {
+    Counters,
+    LatencyHistograms
+};
+
+} // namespace whaleroute
+
+namespace whaleroute::detail {
+
+/// Records latencies to the histogram buckets without locking.
+/// Buckets are split between threads like the route counters and are allocated on the first use by a thread.
+class LatencyRecorder {
+    struct alignas(cacheLineSize) Buckets {
+        std::array<std::atomic<std::uint64_t>, latencyBucketCount> counts = {};
+    };
+
+    struct alignas(cacheLineSize) Stripe {
+        std::atomic<Buckets*> buckets = nullptr;
+    };
+
+public:
+    LatencyRecorder()
+        : stripeCount_{stripeCount()}
+        , stripes_{std::make_unique<Stripe[]>(stripeCount_)}
+    {
+    }
+
+    ~LatencyRecorder()
+    {
+        for (auto i = std::size_t{}; i < stripeCount_; ++i)
+            delete stripes_[i].buckets.load();
+    }
+
+    LatencyRecorder(const LatencyRecorder&) = delete;
+    LatencyRecorder& operator=(const LatencyRecorder&) = delete;
+
+    void record(std::chrono::nanoseconds latency)
+    {
+        auto& stripe = stripes_[threadStripeIndex() % stripeCount_];
+        auto buckets = stripe.buckets.load(std::memory_order_acquire);
+        if (!buckets)
+            buckets = allocateBuckets(stripe);
+        const auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0));
+        buckets->counts[latencyBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    LatencyHistogram histogram() const
+    {
+        auto result = LatencyHistogram{};
+        result.bucketCounts_.resize(latencyBucketCount);
+        for (auto i = std::size_t{}; i < stripeCount_; ++i) {
+            const auto buckets = stripes_[i].buckets.load(std::memory_order_acquire);
+            if (!buckets)
+                continue;
+            for (auto bucketIndex = std::size_t{}; bucketIndex < latencyBucketCount; ++bucketIndex) {
+                const auto count = buckets->counts[bucketIndex].load(std::memory_order_relaxed);
+                result.bucketCounts_[bucketIndex] += count;
+                result.count_ += count;
+            }
+        }
+        return result;
+    }
+
+private:
+    static Buckets* allocateBuckets(Stripe& stripe)
+    {
+        auto buckets = std::make_unique<Buckets>();
+        auto expected = static_cast<Buckets*>(nullptr);
+        if (stripe.buckets.compare_exchange_strong(expected, buckets.get(), std::memory_order_acq_rel))
+            return buckets.release();
+        return expected;
+    }
+
+private:
+    std::size_t stripeCount_;
+    std::unique_ptr<Stripe[]> stripes_;
+};
+
+/// Lock-free counters of a route.
+/// Counters are split into cache line sized stripes, threads are assigned to stripes in a round-robin manner,
+/// so threads running on different cores don't contend for the same cache line.
+class RouteCounters {
+    struct alignas(cacheLineSize) Stripe {
+        std::atomic<std::uint64_t> matchCount = 0;
+        std::atomic<std::uint64_t> invocationCount = 0;
+        std::atomic<std::uint64_t> routeParameterErrorCount = 0;
+        std::atomic<std::uint64_t> processingTimeNs = 0;
+    };
+
+public:
+    RouteCounters()
+        : stripeCount_{stripeCount()}
+        , stripes_{std::make_unique<Stripe[]>(stripeCount_)}
+    {
+    }
+
+    void enableLatencyHistograms(std::size_t processorCount)
+    {
+        if (!routeLatency_)
+            routeLatency_ = std::make_unique<LatencyRecorder>();
+        while (processorLatencyCount_ < processorCount)
+            addProcessorLatency();
+    }
+
+    // Histograms of the new processors are added while registering them, the histograms of the existing
+    // processors stay in place, so they can be used concurrently by the frozen routers
+    void addProcessorLatency()
+    {
+        if (!routeLatency_)
+            return;
+        const auto chunkIndex = processorLatencyChunkIndex(processorLatencyCount_);
+        if (!processorLatencyChunks_.at(chunkIndex))
+            processorLatencyChunks_[chunkIndex] = std::make_unique<LatencyRecorder[]>(std::size_t{1} << chunkIndex);
+        ++processorLatencyCount_;
+    }
+
+    LatencyRecorder* routeLatency() const
+    {
+        return routeLatency_.get();
+    }
+
+    // Returns nullptr if latency histograms aren't enabled
+    LatencyRecorder* processorLatency(std::size_t processorIndex) const
+    {
+        if (!routeLatency_)
+            return nullptr;
+        const auto chunkIndex = processorLatencyChunkIndex(processorIndex);
+        return &processorLatencyChunks_[chunkIndex][processorIndex + 1 - (std::size_t{1} << chunkIndex)];
+    }
+
+    void addMatch()
+    {
+        stripe().matchCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void addInvocation()
+    {
+        stripe().invocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void addRouteParameterError()
+    {
+        stripe().routeParameterErrorCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void addProcessingTime(std::chrono::nanoseconds time)
+    {
+        stripe().processingTimeNs.fetch_add(static_cast<std::uint64_t>(time.count()), std::memory_order_relaxed);
+    }
+
+    RouteStatistics statistics(std::size_t routeIndex, std::string route) const
+    {
+        auto result = RouteStatistics{routeIndex, std::move(route), 0, 0, 0, {}};
+        for (auto i = std::size_t{}; i < stripeCount_; ++i) {
+            const auto& stripe = stripes_[i];
+            result.matchCount += stripe.matchCount.load(std::memory_order_relaxed);
+            result.invocationCount += stripe.invocationCount.load(std::memory_order_relaxed);
+            result.routeParameterErrorCount += stripe.routeParameterErrorCount.load(std::memory_order_relaxed);
+            result.processingTime += std::chrono::nanoseconds{stripe.processingTimeNs.load(std::memory_order_relaxed)};
+        }
+        if (routeLatency_) {
+            result.latency = routeLatency_->histogram();
+            for (auto i = std::size_t{}; i < processorLatencyCount_; ++i)
+                result.processorLatencies.push_back(processorLatency(i)->histogram());
+        }
+        return result;
+    }
+
+private:
+    Stripe& stripe()
+    {
+        return stripes_[threadStripeIndex() % stripeCount_];
+    }
+
+    // Chunk N stores the histograms of processors [2^N - 1, 2^(N+1) - 1)
+    static std::size_t processorLatencyChunkIndex(std::size_t processorIndex)
+    {
+        auto chunkIndex = std::size_t{};
+        while ((processorIndex + 1) >> (chunkIndex + 1))
+            ++chunkIndex;
+        return chunkIndex;
+    }
+
+private:
+    std::size_t stripeCount_;
+    std::unique_ptr<Stripe[]> stripes_;
+    std::unique_ptr<LatencyRecorder> routeLatency_;
+    std::array<std::unique_ptr<LatencyRecorder[]>, 32> processorLatencyChunks_;
+    std::size_t processorLatencyCount_ = 0;
+};
+
+} // namespace whaleroute::detail
+
+#endif // WHALEROUTE_ROUTESTATISTICS_H
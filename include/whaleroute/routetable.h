@@ -0,0 +1,683 @@
+#ifndef WHALEROUTE_ROUTETABLE_H
+#define WHALEROUTE_ROUTETABLE_H
+
+#include "lazyregex.h"
+#include "requestprocessor.h"
+#include "requestprocessorqueue.h"
+#include "routeanalysis.h"
+#include "routematcherinvoker.h"
+#include "routestatistics.h"
+#include "types.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace whaleroute::detail {
+
+struct ParallelMatching {
+    Executor executor;
+    std::size_t shardCount = 0;
+    std::size_t minRouteCount = 0;
+};
+
+template<typename TRequest, typename TResponse, typename TRouteContext>
+class RouteTable {
+public:
+    using ProcessorFunc = RequestProcessorFunc<TRequest, TResponse, TRouteContext>;
+    using ProcessorList = std::vector<ProcessorFunc>;
+    using RouteMatcherList = std::vector<RouteMatcherInvoker<TRequest, TRouteContext>>;
+
+    struct RouteMatch {
+        const ProcessorList* processorList;
+        std::vector<std::string> routeParams;
+        RouteCounters* counters;
+        /// Index of the route in the order of registration
+        std::size_t routeIndex;
+        /// Matchers of the route's group, nullptr if the route isn't registered in a group with matchers
+        const RouteMatcherList* groupMatchers;
+    };
+
+private:
+    struct RouteEntry {
+        std::optional<std::size_t> regexNodeIndex;
+        const ProcessorList* processorList;
+        RouteCounters* counters;
+        std::optional<std::size_t> groupIndex;
+    };
+
+    struct RouteGroupEntry {
+        std::string prefix;
+        const RouteMatcherList* matchers;
+    };
+
+    struct MountEntry {
+        std::string prefix;
+        const RouteTable* table;
+        // Owns the table of a frozen sub-router
+        std::shared_ptr<const RouteTable> tableOwner;
+        // Matches of the sub-router are placed before the routes added after it was mounted
+        std::size_t position;
+    };
+
+    // Routes with the same regular expression are matched once, their indices are stored in the registration order.
+    // Regular expressions of the grouped routes start with the group prefix, so the prefix of the first route's group
+    // can be compared before matching the node.
+    struct RegexNode {
+        const LazyRegex* regExp;
+        std::vector<std::size_t> routeIndices;
+        std::optional<std::size_t> groupIndex;
+        // Literal paths and templates capturing whole segments are preferred by the first-match mode
+        bool isSimple;
+    };
+
+    // Match of a regular expression or a catch-all route
+    struct ParamRouteMatch {
+        std::size_t routeIndex;
+        std::vector<std::string> routeParams;
+    };
+
+    // State of the parallel matching shared with the tasks posted to the executor.
+    // Shards are claimed by the posted tasks and the calling thread, so matching completes
+    // even if the executor doesn't run the posted tasks until the calling thread returns.
+    struct ParallelMatchingState {
+        std::atomic<std::size_t> nextShardIndex = 0;
+        std::vector<std::vector<ParamRouteMatch>> shardMatches;
+        std::vector<std::exception_ptr> shardErrors;
+        std::size_t completedShardCount = 0;
+        std::mutex mutex;
+        std::condition_variable shardCompleted;
+    };
+
+public:
+    // Finds the matched routes one by one in the order of their registration, so that the regular expressions of the
+    // routes after the last processed one aren't matched. Tables mounted at the reached position are matched entirely.
+    class MatchCursor {
+    public:
+        MatchCursor(const RouteTable& table, std::string requestPath)
+            : table_{&table}
+            , requestPath_{std::move(requestPath)}
+            , pathRouteIndices_{&table.findPathRoutes(requestPath_)}
+        {
+            if (!table.catchAllIndex_.empty())
+                catchAllRouteMatches_ = table.withCatchAllRouteMatches(requestPath_, {});
+            if (!table.mounts_.empty())
+                mountIndices_ = table.findMounts(requestPath_);
+        }
+
+        std::optional<RouteMatch> next()
+        {
+            while (true) {
+                if (mountedRouteMatchIndex_ < mountedRouteMatches_.size())
+                    return std::move(mountedRouteMatches_[mountedRouteMatchIndex_++]);
+
+                const auto pathRouteIndex = nextIndex(*pathRouteIndices_, pathRouteIndex_);
+                const auto catchAllRouteIndex = catchAllRouteMatchIndex_ < catchAllRouteMatches_.size()
+                        ? catchAllRouteMatches_[catchAllRouteMatchIndex_].routeIndex
+                        : noIndex;
+                const auto regexRouteIndex = nextIndex(table_->regexRouteIndices_, regexRouteIndex_);
+                const auto routeIndex = std::min({pathRouteIndex, catchAllRouteIndex, regexRouteIndex});
+                // Mounted tables are matched before the routes added after them
+                if (mountIndex_ < mountIndices_.size() &&
+                    table_->mounts_[mountIndices_[mountIndex_]].position <= routeIndex) {
+                    const auto& mount = table_->mounts_[mountIndices_[mountIndex_++]];
+                    mountedRouteMatches_ = table_->matchMountedTable(mount, requestPath_);
+                    mountedRouteMatchIndex_ = 0;
+                    continue;
+                }
+
+                if (routeIndex == noIndex)
+                    return std::nullopt;
+                if (routeIndex == pathRouteIndex) {
+                    ++pathRouteIndex_;
+                    return table_->makeRouteMatch(routeIndex, {});
+                }
+                if (routeIndex == catchAllRouteIndex) {
+                    auto& catchAllRouteMatch = catchAllRouteMatches_[catchAllRouteMatchIndex_++];
+                    return table_->makeRouteMatch(routeIndex, std::move(catchAllRouteMatch.routeParams));
+                }
+                ++regexRouteIndex_;
+                if (auto routeParams = matchRegexRoute(routeIndex))
+                    return table_->makeRouteMatch(routeIndex, std::move(*routeParams));
+            }
+        }
+
+    private:
+        static std::size_t nextIndex(const std::vector<std::size_t>& indices, std::size_t position)
+        {
+            return position < indices.size() ? indices[position] : noIndex;
+        }
+
+        std::optional<std::vector<std::string>> matchRegexRoute(std::size_t routeIndex)
+        {
+            const auto nodeIndex = *table_->routeList_[routeIndex].regexNodeIndex;
+            const auto& node = table_->regexNodes_[nodeIndex];
+            if (node.routeIndices.size() == 1)
+                return table_->matchRegexNode(node, requestPath_);
+
+            // Routes with the same regular expression share the result of its first match
+            auto it = regexNodeMatches_.find(nodeIndex);
+            if (it == regexNodeMatches_.end())
+                it = regexNodeMatches_.emplace(nodeIndex, table_->matchRegexNode(node, requestPath_)).first;
+            return it->second;
+        }
+
+    private:
+        static constexpr auto noIndex = std::numeric_limits<std::size_t>::max();
+        const RouteTable* table_;
+        std::string requestPath_;
+        const std::vector<std::size_t>* pathRouteIndices_;
+        std::size_t pathRouteIndex_ = 0;
+        std::size_t regexRouteIndex_ = 0;
+        std::vector<ParamRouteMatch> catchAllRouteMatches_;
+        std::size_t catchAllRouteMatchIndex_ = 0;
+        std::vector<std::size_t> mountIndices_;
+        std::size_t mountIndex_ = 0;
+        std::vector<RouteMatch> mountedRouteMatches_;
+        std::size_t mountedRouteMatchIndex_ = 0;
+        std::unordered_map<std::size_t, std::optional<std::vector<std::string>>> regexNodeMatches_;
+    };
+
+    explicit RouteTable(
+            TrailingSlashMode trailingSlashMode = TrailingSlashMode::Optional,
+            std::shared_ptr<const void> routerOwner = {})
+        : trailingSlashMode_{trailingSlashMode}
+        , routerOwner_{std::move(routerOwner)}
+    {
+    }
+
+    // The path is stored by reference and must outlive the table. Catch-all routes like /static/*rest match the prefix
+    // and pass the rest of the request path as the route parameter.
+    void addRoute(
+            const std::string& path,
+            const ProcessorList& processorList,
+            RouteCounters* counters = nullptr,
+            std::optional<std::size_t> groupIndex = {})
+    {
+        if (const auto prefix = catchAllRoutePrefix(path))
+            catchAllIndex_[*prefix].push_back(routeList_.size());
+        else
+            pathIndex_[path].push_back(routeList_.size());
+        pathRouteCount_++;
+        routeList_.push_back({std::nullopt, &processorList, counters, groupIndex});
+    }
+
+    void addRoute(
+            const LazyRegex& regExp,
+            const ProcessorList& processorList,
+            RouteCounters* counters = nullptr,
+            std::optional<std::size_t> groupIndex = {})
+    {
+        auto [nodeIt, isNewNode] = regexNodeIndices_.emplace(&regExp, regexNodes_.size());
+        if (isNewNode)
+            regexNodes_.push_back({&regExp, {}, groupIndex, isSimpleRegex(regExp.pattern(), groupIndex)});
+        regexNodes_[nodeIt->second].routeIndices.push_back(routeList_.size());
+        regexRouteIndices_.push_back(routeList_.size());
+        routeList_.push_back({nodeIt->second, &processorList, counters, groupIndex});
+    }
+
+    // Returns the index of the group used when adding its routes. The prefix is a literal path without the trailing
+    // slash, regular expressions of the group's routes must start with it.
+    std::size_t addRouteGroup(std::string prefix, const RouteMatcherList& matchers)
+    {
+        routeGroups_.push_back({std::move(prefix), &matchers});
+        return routeGroups_.size() - 1;
+    }
+
+    // Requests with paths starting with the prefix are also matched with the table using the rest of the path.
+    // The prefix is a literal path without the trailing slash, the table must outlive this one unless it's owned by it.
+    void mount(std::string prefix, const RouteTable& table, std::shared_ptr<const RouteTable> tableOwner = {})
+    {
+        auto& mount =
+                mounts_.emplace_back(MountEntry{std::move(prefix), &table, std::move(tableOwner), routeList_.size()});
+        mountIndex_[mount.prefix].push_back(mounts_.size() - 1);
+    }
+
+    // Allocates the storage for the routes added next, so the path index isn't rehashed while adding them
+    void reserve(std::size_t pathRouteCount, std::size_t regexRouteCount)
+    {
+        routeList_.reserve(routeList_.size() + pathRouteCount + regexRouteCount);
+        pathIndex_.reserve(pathIndex_.size() + pathRouteCount);
+        regexNodes_.reserve(regexNodes_.size() + regexRouteCount);
+        regexRouteIndices_.reserve(regexRouteIndices_.size() + regexRouteCount);
+        regexNodeIndices_.reserve(regexNodeIndices_.size() + regexRouteCount);
+    }
+
+    void setRouteCounters(std::size_t routeIndex, RouteCounters* counters)
+    {
+        routeList_.at(routeIndex).counters = counters;
+    }
+
+    void setUnmatchedRequestProcessors(const ProcessorList& processorList)
+    {
+        unmatchedRequestProcessorList_ = &processorList;
+    }
+
+    // Stores a copy of the processor list in the table, so that it isn't affected by later changes of the route
+    const ProcessorList& storeProcessorList(const ProcessorList& processorList)
+    {
+        return storedProcessorLists_.emplace_back(processorList);
+    }
+
+    void setTrailingSlashMode(TrailingSlashMode mode)
+    {
+        trailingSlashMode_ = mode;
+    }
+
+    TrailingSlashMode trailingSlashMode() const
+    {
+        return trailingSlashMode_;
+    }
+
+    void setMatchingMode(MatchingMode mode)
+    {
+        matchingMode_ = mode;
+    }
+
+    MatchingMode matchingMode() const
+    {
+        return matchingMode_;
+    }
+
+    void setParallelMatching(ParallelMatching parallelMatching)
+    {
+        parallelMatching_ = std::move(parallelMatching);
+    }
+
+    const ParallelMatching& parallelMatching() const
+    {
+        return parallelMatching_;
+    }
+
+    const ProcessorList& unmatchedRequestProcessors() const
+    {
+        return unmatchedRequestProcessorList_ ? *unmatchedRequestProcessorList_ : emptyProcessorList_;
+    }
+
+    // Incremental matching isn't used in the first-match mode and when regular expressions are matched in parallel
+    bool canMatchIncrementally() const
+    {
+        return matchingMode_ == MatchingMode::AllMatches && !isParallelMatchingUsed();
+    }
+
+    MatchCursor matchIncrementally(std::string requestPath) const
+    {
+        return MatchCursor{*this, std::move(requestPath)};
+    }
+
+    // Returns the matched routes in the order of their registration, or the most specific ones in the first-match mode
+    std::vector<RouteMatch> match(std::string_view requestPath) const
+    {
+        if (matchingMode_ == MatchingMode::FirstMatch)
+            return matchFirst(requestPath);
+
+        auto result = std::vector<RouteMatch>{};
+        const auto& pathRouteIndices = findPathRoutes(requestPath);
+        auto pathRouteIt = pathRouteIndices.begin();
+        auto addPathRoutesBefore = [&](std::size_t routeIndex)
+        {
+            for (; pathRouteIt != pathRouteIndices.end() && *pathRouteIt < routeIndex; ++pathRouteIt)
+                result.push_back(makeRouteMatch(*pathRouteIt, {}));
+        };
+
+        auto paramRouteMatches = matchRegexRoutes(requestPath);
+        if (!catchAllIndex_.empty())
+            paramRouteMatches = withCatchAllRouteMatches(requestPath, std::move(paramRouteMatches));
+        for (auto& paramRouteMatch : paramRouteMatches) {
+            addPathRoutesBefore(paramRouteMatch.routeIndex);
+            result.push_back(makeRouteMatch(paramRouteMatch.routeIndex, std::move(paramRouteMatch.routeParams)));
+        }
+        addPathRoutesBefore(routeList_.size());
+        if (!mounts_.empty())
+            return withMountedRouteMatches(requestPath, std::move(result));
+        return result;
+    }
+
+private:
+    // Returns the routes of the most specific matching path or regular expression in the order of their registration.
+    // Literal paths are preferred over segment templates, catch-all routes and mounted tables with longer prefixes
+    // and other regular expressions, the lookup stops at the first matching tier.
+    std::vector<RouteMatch> matchFirst(std::string_view requestPath) const
+    {
+        auto result = std::vector<RouteMatch>{};
+        for (auto routeIndex : findPathRoutes(requestPath))
+            result.push_back(makeRouteMatch(routeIndex, {}));
+        if (result.empty())
+            result = matchFirstRegexNode(requestPath, true);
+        if (result.empty() && (!catchAllIndex_.empty() || !mounts_.empty()))
+            result = matchLongestPrefix(requestPath);
+        if (result.empty())
+            result = matchFirstRegexNode(requestPath, false);
+        return result;
+    }
+
+    std::vector<RouteMatch> matchFirstRegexNode(std::string_view requestPath, bool isSimple) const
+    {
+        auto result = std::vector<RouteMatch>{};
+        for (const auto& node : regexNodes_) {
+            if (node.isSimple != isSimple)
+                continue;
+            auto routeParams = matchRegexNode(node, requestPath);
+            if (!routeParams)
+                continue;
+            for (auto routeIndex : node.routeIndices)
+                result.push_back(makeRouteMatch(routeIndex, *routeParams));
+            break;
+        }
+        return result;
+    }
+
+    // Catch-all routes are preferred over mounted tables with the same prefix
+    std::vector<RouteMatch> matchLongestPrefix(std::string_view requestPath) const
+    {
+        auto result = std::vector<RouteMatch>{};
+        for (auto prefixSize = requestPath.size() + 1; prefixSize-- > 0 && result.empty();) {
+            if (prefixSize != requestPath.size() && requestPath[prefixSize] != '/')
+                continue;
+            const auto prefix = requestPath.substr(0, prefixSize);
+            if (auto it = catchAllIndex_.find(prefix); it != catchAllIndex_.end()) {
+                const auto rest = prefixSize < requestPath.size() ? requestPath.substr(prefixSize + 1) : "";
+                for (auto routeIndex : it->second)
+                    result.push_back(makeRouteMatch(routeIndex, {std::string{rest}}));
+            }
+            else if (auto it = mountIndex_.find(prefix); it != mountIndex_.end())
+                for (auto mountIndex : it->second)
+                    concat(result, matchMountedTable(mounts_[mountIndex], requestPath));
+        }
+        return result;
+    }
+
+    // Returns the indices of the tables mounted under the prefixes of the path in the order of mounting
+    std::vector<std::size_t> findMounts(std::string_view requestPath) const
+    {
+        auto mountIndices = std::vector<std::size_t>{};
+        forEachPathPrefix(
+                requestPath,
+                [&](std::size_t prefixSize)
+                {
+                    auto it = mountIndex_.find(requestPath.substr(0, prefixSize));
+                    if (it != mountIndex_.end())
+                        concat(mountIndices, it->second);
+                });
+        std::sort(mountIndices.begin(), mountIndices.end());
+        return mountIndices;
+    }
+
+    std::vector<RouteMatch> matchMountedTable(const MountEntry& mount, std::string_view requestPath) const
+    {
+        const auto mountedPath = requestPath.substr(mount.prefix.size());
+        return mount.table->match(mountedPath.empty() ? std::string_view{"/"} : mountedPath);
+    }
+
+    // Expressions of the grouped routes are made of the escaped group prefix and the route's expression wrapped
+    // in a non-capturing group, the latter is checked
+    bool isSimpleRegex(std::string_view pattern, std::optional<std::size_t> groupIndex) const
+    {
+        if (groupIndex) {
+            const auto& prefix = routeGroups_[*groupIndex].prefix;
+            const auto wrapperSize = escapeRegex(prefix).size() + std::string_view{"(?:"}.size();
+            if (pattern.size() <= wrapperSize)
+                return false;
+            pattern = pattern.substr(wrapperSize, pattern.size() - wrapperSize - 1);
+        }
+        return simplifyRegex(pattern).has_value();
+    }
+
+    RouteMatch makeRouteMatch(std::size_t routeIndex, std::vector<std::string> routeParams) const
+    {
+        const auto& route = routeList_[routeIndex];
+        return {route.processorList, std::move(routeParams), route.counters, routeIndex, groupMatchers(route)};
+    }
+
+    std::vector<RouteMatch> withMountedRouteMatches(std::string_view requestPath, std::vector<RouteMatch> matches)
+            const
+    {
+        const auto mountIndices = findMounts(requestPath);
+        if (mountIndices.empty())
+            return matches;
+
+        auto result = std::vector<RouteMatch>{};
+        auto matchIt = matches.begin();
+        for (auto mountIndex : mountIndices) {
+            const auto& mount = mounts_[mountIndex];
+            for (; matchIt != matches.end() && matchIt->routeIndex < mount.position; ++matchIt)
+                result.push_back(std::move(*matchIt));
+            auto mountedMatches = matchMountedTable(mount, requestPath);
+            std::move(mountedMatches.begin(), mountedMatches.end(), std::back_inserter(result));
+        }
+        std::move(matchIt, matches.end(), std::back_inserter(result));
+        return result;
+    }
+
+    // Catch-all routes are merged with the matched regular expression routes in the order of registration
+    std::vector<ParamRouteMatch> withCatchAllRouteMatches(
+            std::string_view requestPath,
+            std::vector<ParamRouteMatch> regexRouteMatches) const
+    {
+        auto catchAllRouteMatches = std::vector<ParamRouteMatch>{};
+        forEachPathPrefix(
+                requestPath,
+                [&](std::size_t prefixSize)
+                {
+                    auto it = catchAllIndex_.find(requestPath.substr(0, prefixSize));
+                    if (it == catchAllIndex_.end())
+                        return;
+                    const auto rest = prefixSize < requestPath.size() ? requestPath.substr(prefixSize + 1) : "";
+                    for (auto routeIndex : it->second)
+                        catchAllRouteMatches.push_back({routeIndex, {std::string{rest}}});
+                });
+        if (catchAllRouteMatches.empty())
+            return regexRouteMatches;
+
+        auto byRouteIndex = [](const ParamRouteMatch& lhs, const ParamRouteMatch& rhs)
+        {
+            return lhs.routeIndex < rhs.routeIndex;
+        };
+        std::sort(catchAllRouteMatches.begin(), catchAllRouteMatches.end(), byRouteIndex);
+        auto result = std::vector<ParamRouteMatch>{};
+        result.reserve(regexRouteMatches.size() + catchAllRouteMatches.size());
+        std::merge(
+                std::make_move_iterator(regexRouteMatches.begin()),
+                std::make_move_iterator(regexRouteMatches.end()),
+                std::make_move_iterator(catchAllRouteMatches.begin()),
+                std::make_move_iterator(catchAllRouteMatches.end()),
+                std::back_inserter(result),
+                byRouteIndex);
+        return result;
+    }
+
+    // Invokes the function with the size of each prefix of the path ending before a slash or at the end of the path
+    template<typename TFunc>
+    static void forEachPathPrefix(std::string_view path, TFunc func)
+    {
+        for (auto pos = std::size_t{}; pos <= path.size(); ++pos)
+            if (pos == path.size() || path[pos] == '/')
+                func(pos);
+    }
+
+    std::vector<ParamRouteMatch> matchRegexRoutes(std::string_view requestPath) const
+    {
+        if (!isParallelMatchingUsed())
+            return sortedByRouteIndex(matchRegexRoutes(requestPath, 0, regexNodes_.size()));
+
+        const auto shardCount = parallelMatching_.shardCount;
+        auto state = std::make_shared<ParallelMatchingState>();
+        state->shardMatches.resize(shardCount);
+        state->shardErrors.resize(shardCount);
+        // Posted tasks that start after all shards are claimed don't access the table and the request path
+        auto matchShards = [this, requestPath, state = std::weak_ptr<ParallelMatchingState>{state}]
+        {
+            if (auto lockedState = state.lock())
+                matchNextShards(*lockedState, requestPath);
+        };
+        for (auto i = std::size_t{1}; i < shardCount; ++i)
+            parallelMatching_.executor(matchShards);
+        matchNextShards(*state, requestPath);
+
+        auto lock = std::unique_lock{state->mutex};
+        state->shardCompleted.wait(
+                lock,
+                [&]
+                {
+                    return state->completedShardCount == shardCount;
+                });
+
+        auto result = std::vector<ParamRouteMatch>{};
+        for (auto shardIndex = std::size_t{}; shardIndex < shardCount; ++shardIndex) {
+            if (state->shardErrors[shardIndex])
+                std::rethrow_exception(state->shardErrors[shardIndex]);
+            auto& shardMatches = state->shardMatches[shardIndex];
+            std::move(shardMatches.begin(), shardMatches.end(), std::back_inserter(result));
+        }
+        return sortedByRouteIndex(std::move(result));
+    }
+
+    bool isParallelMatchingUsed() const
+    {
+        return parallelMatching_.executor && parallelMatching_.shardCount >= 2 &&
+                regexNodes_.size() >= std::max(parallelMatching_.minRouteCount, parallelMatching_.shardCount);
+    }
+
+    void matchNextShards(ParallelMatchingState& state, std::string_view requestPath) const
+    {
+        const auto shardCount = state.shardMatches.size();
+        for (auto shardIndex = state.nextShardIndex++; shardIndex < shardCount; shardIndex = state.nextShardIndex++) {
+            const auto shardSize = (regexNodes_.size() + shardCount - 1) / shardCount;
+            const auto begin = std::min(shardIndex * shardSize, regexNodes_.size());
+            const auto end = std::min(begin + shardSize, regexNodes_.size());
+            try {
+                state.shardMatches[shardIndex] = matchRegexRoutes(requestPath, begin, end);
+            }
+            catch (...) {
+                state.shardErrors[shardIndex] = std::current_exception();
+            }
+            {
+                auto lock = std::lock_guard{state.mutex};
+                state.completedShardCount++;
+            }
+            state.shardCompleted.notify_one();
+        }
+    }
+
+    std::vector<ParamRouteMatch> matchRegexRoutes(std::string_view requestPath, std::size_t begin, std::size_t end)
+            const
+    {
+        auto result = std::vector<ParamRouteMatch>{};
+        // Group prefixes are compared once, a mismatch skips all regular expression routes of the group
+        auto groupPrefixMatches = std::vector<std::optional<bool>>(routeGroups_.size());
+        for (auto i = begin; i < end; ++i) {
+            const auto& node = regexNodes_[i];
+            if (node.groupIndex) {
+                auto& prefixMatch = groupPrefixMatches[*node.groupIndex];
+                if (!prefixMatch)
+                    prefixMatch = startsWith(requestPath, routeGroups_[*node.groupIndex].prefix);
+                if (!*prefixMatch)
+                    continue;
+            }
+            auto routeParams = matchRegex(*node.regExp, requestPath);
+            if (!routeParams)
+                continue;
+            for (auto routeIndex : node.routeIndices)
+                result.push_back({routeIndex, *routeParams});
+        }
+        return result;
+    }
+
+    // Returns the values of the capturing groups if the regular expression matches the path
+    static std::optional<std::vector<std::string>> matchRegex(const LazyRegex& regExp, std::string_view requestPath)
+    {
+        auto matchList = std::match_results<std::string_view::const_iterator>{};
+        if (!std::regex_match(requestPath.begin(), requestPath.end(), matchList, regExp.get()))
+            return std::nullopt;
+
+        auto routeParams = std::vector<std::string>{};
+        for (auto paramIndex = 1u; paramIndex < matchList.size(); ++paramIndex)
+            routeParams.push_back(matchList[paramIndex].str());
+        return routeParams;
+    }
+
+    std::optional<std::vector<std::string>> matchRegexNode(const RegexNode& node, std::string_view requestPath) const
+    {
+        if (node.groupIndex && !startsWith(requestPath, routeGroups_[*node.groupIndex].prefix))
+            return std::nullopt;
+        return matchRegex(*node.regExp, requestPath);
+    }
+
+    static bool startsWith(std::string_view value, std::string_view prefix)
+    {
+        return value.substr(0, prefix.size()) == prefix;
+    }
+
+    // Matches of the nodes are ordered by their first routes, so they need sorting if nodes have multiple routes
+    std::vector<ParamRouteMatch> sortedByRouteIndex(std::vector<ParamRouteMatch> matches) const
+    {
+        if (regexNodes_.size() == regexRouteCount())
+            return matches;
+        std::sort(
+                matches.begin(),
+                matches.end(),
+                [](const ParamRouteMatch& lhs, const ParamRouteMatch& rhs)
+                {
+                    return lhs.routeIndex < rhs.routeIndex;
+                });
+        return matches;
+    }
+
+    const RouteMatcherList* groupMatchers(const RouteEntry& route) const
+    {
+        if (!route.groupIndex || routeGroups_[*route.groupIndex].matchers->empty())
+            return nullptr;
+        return routeGroups_[*route.groupIndex].matchers;
+    }
+
+    std::size_t regexRouteCount() const
+    {
+        return routeList_.size() - pathRouteCount_;
+    }
+
+    const std::vector<std::size_t>& findPathRoutes(std::string_view requestPath) const
+    {
+        auto it = pathIndex_.find(requestPath);
+        if (it == pathIndex_.end())
+            return emptyRouteIndices_;
+        return it->second;
+    }
+
+private:
+    std::vector<RouteEntry> routeList_;
+    std::unordered_map<std::string_view, std::vector<std::size_t>> pathIndex_;
+    std::unordered_map<std::string_view, std::vector<std::size_t>> catchAllIndex_;
+    std::size_t pathRouteCount_ = 0;
+    std::vector<RegexNode> regexNodes_;
+    std::vector<std::size_t> regexRouteIndices_;
+    std::unordered_map<const LazyRegex*, std::size_t> regexNodeIndices_;
+    std::vector<RouteGroupEntry> routeGroups_;
+    std::deque<MountEntry> mounts_;
+    std::unordered_map<std::string_view, std::vector<std::size_t>> mountIndex_;
+    const ProcessorList* unmatchedRequestProcessorList_ = nullptr;
+    std::deque<ProcessorList> storedProcessorLists_;
+    TrailingSlashMode trailingSlashMode_;
+    ParallelMatching parallelMatching_;
+    MatchingMode matchingMode_ = MatchingMode::AllMatches;
+    // Keeps the router alive while the table is in use, if the router is owned by a shared pointer
+    std::shared_ptr<const void> routerOwner_;
+    inline static const ProcessorList emptyProcessorList_ = {};
+    inline static const std::vector<std::size_t> emptyRouteIndices_ = {};
+};
+
+} // namespace whaleroute::detail
+
+#endif // WHALEROUTE_ROUTETABLE_H
@@ -0,0 +1,120 @@
+#ifndef WHALEROUTE_ROUTETABLESNAPSHOT_H
+#define WHALEROUTE_ROUTETABLESNAPSHOT_H
+
+#include "types.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace whaleroute::detail {
+
+enum class SnapshotRouteKind : std::uint8_t {
+    Path,
+    Regex
+};
+
+struct SnapshotRoute {
+    std::size_t routeId;
+    SnapshotRouteKind kind;
+    /// Path of the route or the regular expression as it was registered
+    std::string value;
+};
+
+struct RouteTableSnapshot {
+    TrailingSlashMode trailingSlashMode;
+    std::vector<SnapshotRoute> routes;
+};
+
+inline constexpr std::string_view routeTableSnapshotSignature = "WRTS";
+inline constexpr std::uint8_t routeTableSnapshotVersion = 1;
+
+// Snapshot layout, integers are stored in little-endian byte order:
+//   signature, version: u8, trailing slash mode: u8, route count: u32,
+//   routes: {route id: u32, kind: u8, value size: u32, value bytes}
+class RouteTableSnapshotWriter {
+public:
+    std::string write(const RouteTableSnapshot& snapshot)
+    {
+        data_ = std::string{routeTableSnapshotSignature};
+        writeInt(routeTableSnapshotVersion, 1);
+        writeInt(static_cast<std::uint32_t>(snapshot.trailingSlashMode), 1);
+        writeInt(snapshot.routes.size(), 4);
+        for (const auto& route : snapshot.routes) {
+            writeInt(route.routeId, 4);
+            writeInt(static_cast<std::uint32_t>(route.kind), 1);
+            writeInt(route.value.size(), 4);
+            data_ += route.value;
+        }
+        return std::move(data_);
+    }
+
+private:
+    void writeInt(std::uint64_t value, std::size_t size)
+    {
+        for (auto i = std::size_t{}; i < size; ++i)
+            data_ += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+
+private:
+    std::string data_;
+};
+
+class RouteTableSnapshotReader {
+public:
+    explicit RouteTableSnapshotReader(std::string_view data)
+        : data_{data}
+    {
+    }
+
+    // Returns std::nullopt if the data isn't a valid snapshot
+    std::optional<RouteTableSnapshot> read()
+    {
+        if (data_.substr(0, routeTableSnapshotSignature.size()) != routeTableSnapshotSignature)
+            return std::nullopt;
+        pos_ = routeTableSnapshotSignature.size();
+
+        const auto version = readInt(1);
+        const auto trailingSlashMode = readInt(1);
+        const auto routeCount = readInt(4);
+        if (!version || *version != routeTableSnapshotVersion || !trailingSlashMode || *trailingSlashMode > 1 ||
+            !routeCount)
+            return std::nullopt;
+
+        auto result = RouteTableSnapshot{static_cast<TrailingSlashMode>(*trailingSlashMode), {}};
+        for (auto i = std::size_t{}; i < *routeCount; ++i) {
+            const auto routeId = readInt(4);
+            const auto kind = readInt(1);
+            const auto valueSize = readInt(4);
+            if (!routeId || *routeId != i || !kind || *kind > 1 || !valueSize || data_.size() - pos_ < *valueSize)
+                return std::nullopt;
+            result.routes.push_back(
+                    {i, static_cast<SnapshotRouteKind>(*kind), std::string{data_.substr(pos_, *valueSize)}});
+            pos_ += *valueSize;
+        }
+        if (pos_ != data_.size())
+            return std::nullopt;
+        return result;
+    }
+
+private:
+    std::optional<std::size_t> readInt(std::size_t size)
+    {
+        if (data_.size() - pos_ < size)
+            return std::nullopt;
+        auto result = std::size_t{};
+        for (auto i = std::size_t{}; i < size; ++i)
+            result |= std::size_t{static_cast<unsigned char>(data_[pos_ + i])} << (8 * i);
+        pos_ += size;
+        return result;
+    }
+
+private:
+    std::string_view data_;
+    std::size_t pos_ = 0;
+};
+
+} // namespace whaleroute::detail
+
+#endif // WHALEROUTE_ROUTETABLESNAPSHOT_H
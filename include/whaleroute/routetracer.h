@@ -0,0 +1,93 @@
+#ifndef WHALEROUTE_ROUTETRACER_H
+#define WHALEROUTE_ROUTETRACER_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace whaleroute::config {
+/// Specialize to receive the tracing events of the routers processing TRequest.
+/// Any subset of the following methods can be implemented, routers don't generate the code for missing ones:
+///   void onRouteMatched(const TRequest&, std::size_t routeId);
+///   void onProcessorStarted(const TRequest&, std::size_t routeId, std::size_t processorIndex);
+///   void onProcessorFinished(const TRequest&, std::size_t routeId, std::size_t processorIndex);
+///   void onRequestUnmatched(const TRequest&);
+template<typename TRequest>
+struct RouteTracer;
+
+} // namespace whaleroute::config
+
+namespace whaleroute::detail {
+
+template<typename TRequest, typename = void>
+struct HasOnRouteMatched : std::false_type {};
+
+template<typename TRequest>
+struct HasOnRouteMatched<
+        TRequest,
+        std::void_t<decltype(std::declval<config::RouteTracer<TRequest>&>().onRouteMatched(
+                std::declval<const TRequest&>(),
+                std::size_t{}))>> : std::true_type {};
+
+template<typename TRequest, typename = void>
+struct HasOnProcessorStarted : std::false_type {};
+
+template<typename TRequest>
+struct HasOnProcessorStarted<
+        TRequest,
+        std::void_t<decltype(std::declval<config::RouteTracer<TRequest>&>().onProcessorStarted(
+                std::declval<const TRequest&>(),
+                std::size_t{},
+                std::size_t{}))>> : std::true_type {};
+
+template<typename TRequest, typename = void>
+struct HasOnProcessorFinished : std::false_type {};
+
+template<typename TRequest>
+struct HasOnProcessorFinished<
+        TRequest,
+        std::void_t<decltype(std::declval<config::RouteTracer<TRequest>&>().onProcessorFinished(
+                std::declval<const TRequest&>(),
+                std::size_t{},
+                std::size_t{}))>> : std::true_type {};
+
+template<typename TRequest, typename = void>
+struct HasOnRequestUnmatched : std::false_type {};
+
+template<typename TRequest>
+struct HasOnRequestUnmatched<
+        TRequest,
+        std::void_t<decltype(std::declval<config::RouteTracer<TRequest>&>().onRequestUnmatched(
+                std::declval<const TRequest&>()))>> : std::true_type {};
+
+template<typename TRequest>
+void traceRouteMatched(const TRequest& request, std::size_t routeId)
+{
+    if constexpr (HasOnRouteMatched<TRequest>::value)
+        config::RouteTracer<TRequest>{}.onRouteMatched(request, routeId);
+}
+
+template<typename TRequest>
+void traceProcessorStarted(const TRequest& request, std::size_t routeId, std::size_t processorIndex)
+{
+    if constexpr (HasOnProcessorStarted<TRequest>::value)
+        config::RouteTracer<TRequest>{}.onProcessorStarted(request, routeId, processorIndex);
+}
+
+template<typename TRequest>
+void traceProcessorFinished(const TRequest& request, std::size_t routeId, std::size_t processorIndex)
+{
+    if constexpr (HasOnProcessorFinished<TRequest>::value)
+        config::RouteTracer<TRequest>{}.onProcessorFinished(request, routeId, processorIndex);
+}
+
+template<typename TRequest>
+void traceRequestUnmatched(const TRequest& request)
+{
+    if constexpr (HasOnRequestUnmatched<TRequest>::value)
+        config::RouteTracer<TRequest>{}.onRequestUnmatched(request);
+}
+
+} // namespace whaleroute::detail
+
+#endif // WHALEROUTE_ROUTETRACER_H
@@ -0,0 +1,254 @@
+#ifndef WHALEROUTE_TASK_H
+#define WHALEROUTE_TASK_H
+
+#include "requestprocessorqueue.h"
+#include <type_traits>
+
+namespace whaleroute {
+template<typename T = void>
+class Task;
+}
+
+namespace whaleroute::detail {
+
+template<typename T>
+struct IsTask : std::false_type {};
+
+template<typename T>
+struct IsTask<Task<T>> : std::true_type {};
+
+template<typename T>
+struct UnwrapTask {
+    using type = T;
+};
+
+template<typename T>
+struct UnwrapTask<Task<T>> {
+    using type = T;
+};
+
+template<typename T>
+using UnwrapTaskType = typename UnwrapTask<T>::type;
+
+template<typename TResponseConverter, typename T, typename TResponse>
+AsyncOperation makeTaskOperation(Task<T>&& task, TResponse& response);
+
+} // namespace whaleroute::detail
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace whaleroute::detail {
+
+class TaskPromiseBase {
+    struct FinalAwaiter {
+        bool await_ready() noexcept
+        {
+            return false;
+        }
+
+        template<typename TPromise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept
+        {
+            auto& promise = handle.promise();
+            if (promise.continuation_)
+                return promise.continuation_;
+
+            // The coroutine was launched by the request processor queue and owns itself
+            auto completionHandler = std::move(promise.completionHandler_);
+            completionHandler();
+            handle.destroy();
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept
+        {
+        }
+    };
+
+public:
+    std::suspend_always initial_suspend() noexcept
+    {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception()
+    {
+        exception_ = std::current_exception();
+    }
+
+    void setContinuation(std::coroutine_handle<> continuation)
+    {
+        continuation_ = continuation;
+    }
+
+    void setCompletionHandler(std::function<void()> completionHandler)
+    {
+        completionHandler_ = std::move(completionHandler);
+    }
+
+protected:
+    void rethrowException()
+    {
+        if (exception_)
+            std::rethrow_exception(exception_);
+    }
+
+private:
+    std::coroutine_handle<> continuation_;
+    std::function<void()> completionHandler_;
+    std::exception_ptr exception_;
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object();
+
+    template<typename TValue>
+    void return_value(TValue&& value)
+    {
+        result_.emplace(std::forward<TValue>(value));
+    }
+
+    T takeResult()
+    {
+        rethrowException();
+        return std::move(*result_);
+    }
+
+private:
+    std::optional<T> result_;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object();
+
+    void return_void()
+    {
+    }
+
+    void takeResult()
+    {
+        rethrowException();
+    }
+};
+
+} // namespace whaleroute::detail
+
+namespace whaleroute {
+
+/// Return type of coroutine request processors.
+/// Task<void> is used by processors writing the response themselves, Task<T> by processors returning a response value.
+/// Tasks can also be awaited by other tasks.
+/// An exception escaping a coroutine request processor terminates the program.
+template<typename T>
+class Task {
+    template<typename TResponseConverter, typename TValue, typename TResponse>
+    friend detail::AsyncOperation detail::makeTaskOperation(Task<TValue>&& task, TResponse& response);
+
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : handle_{handle}
+    {
+    }
+
+    Task(Task&& other) noexcept
+        : handle_{std::exchange(other.handle_, {})}
+    {
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    ~Task()
+    {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+    {
+        handle_.promise().setContinuation(continuation);
+        return handle_;
+    }
+
+    T await_resume()
+    {
+        return handle_.promise().takeResult();
+    }
+
+private:
+    std::coroutine_handle<promise_type> release()
+    {
+        return std::exchange(handle_, {});
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+} // namespace whaleroute
+
+namespace whaleroute::detail {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object()
+{
+    return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+inline Task<void> TaskPromise<void>::get_return_object()
+{
+    return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+}
+
+template<typename TResponseConverter, typename T, typename TResponse>
+AsyncOperation makeTaskOperation(Task<T>&& task, TResponse& response)
+{
+    auto handle = task.release();
+    return [handle, &response](const Executor&, std::function<void()> onCompleted)
+    {
+        handle.promise().setCompletionHandler(
+                [handle, &response, onCompleted = std::move(onCompleted)]
+                {
+                    if constexpr (std::is_same_v<T, void>)
+                        handle.promise().takeResult();
+                    else
+                        TResponseConverter{}(response, handle.promise().takeResult());
+                    onCompleted();
+                });
+        handle.resume();
+    };
+}
+
+} // namespace whaleroute::detail
+
+#endif
+
+#endif // WHALEROUTE_TASK_H
@@ -20,6 +20,13 @@ enum class TrailingSlashMode {
     Strict
 };
 
+enum class MatchingMode {
+    /// Requests are processed by all matching routes in the order of registration
+    AllMatches,
+    /// Requests are processed by the routes with the most specific matching path or regular expression
+    FirstMatch
+};
+
 struct rx {
     std::string value;
 };
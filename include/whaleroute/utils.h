@@ -6,6 +6,7 @@
 #include "external/sfun/string_utils.h"
 #include <algorithm>
 #include <functional>
+#include <optional>
 #include <regex>
 #include <string>
 #include <string_view>
@@ -13,12 +14,27 @@
 
 namespace whaleroute::detail {
 
+inline constexpr std::size_t cacheLineSize = 64;
+
 template<typename, typename = void>
 struct IsCompleteType : std::false_type {};
 
 template<typename T>
 struct IsCompleteType<T, std::void_t<decltype(sizeof(T))>> : std::true_type {};
 
+template<typename T>
+struct UnwrapReference {
+    using type = T;
+};
+
+template<typename T>
+struct UnwrapReference<std::reference_wrapper<T>> {
+    using type = T&;
+};
+
+template<typename T>
+using UnwrapRefDecay = typename UnwrapReference<std::decay_t<T>>::type;
+
 template<typename TDst, typename TSrc>
 void concat(TDst& dst, const TSrc& src)
 {
@@ -43,22 +59,56 @@ inline std::string makePath(const std::string& path, TrailingSlashMode mode)
     return path;
 }
 
-inline std::regex makeRegex(const rx& regExp, TrailingSlashMode mode)
+inline bool isRegexSpecialCharacter(char ch)
+{
+    return std::string_view{"^$.|?*+()[]{}"}.find(ch) != std::string_view::npos;
+}
+
+inline std::string escapeRegex(std::string_view value)
+{
+    auto result = std::string{};
+    for (auto ch : value) {
+        if (ch == '\\' || isRegexSpecialCharacter(ch))
+            result += '\\';
+        result += ch;
+    }
+    return result;
+}
+
+// Route group prefixes are stored without the trailing slash, so that child paths can be appended to them
+inline std::string makeRouteGroupPrefix(const std::string& prefix)
+{
+    if (!prefix.empty() && prefix.back() == '/')
+        return {prefix.begin(), prefix.end() - 1};
+    return prefix;
+}
+
+// Returns the prefix of the catch-all route path like /static/*rest without the trailing slash,
+// or std::nullopt if the last path segment doesn't start with an asterisk
+inline std::optional<std::string_view> catchAllRoutePrefix(std::string_view path)
+{
+    const auto pos = path.rfind('/');
+    if (pos == std::string_view::npos || pos + 1 == path.size() || path[pos + 1] != '*')
+        return std::nullopt;
+    return path.substr(0, pos);
+}
+
+inline std::string makeRegexPattern(const rx& regExp, TrailingSlashMode mode)
 {
     if (mode == TrailingSlashMode::Strict)
-        return std::regex{regExp.value};
+        return regExp.value;
 
     auto rxVal = regExp.value;
     if (sfun::ends_with(rxVal, "/")) {
         rxVal.pop_back();
-        return std::regex{rxVal};
+        return rxVal;
     }
     else if (sfun::ends_with(rxVal, "/)")) {
         rxVal[rxVal.size() - 1] = '?';
         rxVal += ')';
-        return std::regex{rxVal};
+        return rxVal;
     }
-    return std::regex{rxVal};
+    return rxVal;
 }
 
 } // namespace whaleroute::detail
@@ -0,0 +1,357 @@
+#include "../common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> isCountingAllocations = false;
+std::atomic<std::size_t> allocationCount = 0;
+std::atomic<std::size_t> deallocationCount = 0;
+
+void* allocate(std::size_t size)
+{
+    if (isCountingAllocations.load(std::memory_order_relaxed))
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void* allocate(std::size_t size, std::align_val_t alignment)
+{
+    if (isCountingAllocations.load(std::memory_order_relaxed))
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    const auto alignmentValue = static_cast<std::size_t>(alignment);
+    const auto alignedSize = (std::max<std::size_t>(size, 1) + alignmentValue - 1) / alignmentValue * alignmentValue;
+    if (auto ptr = std::aligned_alloc(alignmentValue, alignedSize))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void deallocate(void* ptr) noexcept
+{
+    if (!ptr)
+        return;
+    if (isCountingAllocations.load(std::memory_order_relaxed))
+        deallocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::free(ptr);
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+
+struct Context {
+    int counter = 0;
+};
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestType, Context> {
+    bool operator()(const RequestType& value, const Request& request, const Context&) const
+    {
+        return value == request.type;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct AllocationStats {
+    std::size_t allocationCount;
+    std::size_t deallocationCount;
+
+    friend bool operator==(const AllocationStats& lhs, const AllocationStats& rhs)
+    {
+        return lhs.allocationCount == rhs.allocationCount && lhs.deallocationCount == rhs.deallocationCount;
+    }
+
+    friend std::ostream& operator<<(std::ostream& stream, const AllocationStats& stats)
+    {
+        return stream << "{allocations: " << stats.allocationCount << ", deallocations: " << stats.deallocationCount
+                      << "}";
+    }
+};
+
+template<typename TFunc>
+AllocationStats countAllocations(TFunc&& func)
+{
+    allocationCount = 0;
+    deallocationCount = 0;
+    isCountingAllocations = true;
+    func();
+    isCountingAllocations = false;
+    return {allocationCount, deallocationCount};
+}
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class Router : public whaleroute::RequestRouter<Request, Response, ResponseSender, Context> {
+public:
+    void onRouteParametersError(const Request&, Response& response, const whaleroute::RouteParameterError& error)
+            override
+    {
+        response.send(getRouteParamErrorInfo(error));
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+// Routes of the Router.Matching and Router.MultipleRoutesMatching tests from test_router.cpp
+void registerRoutes(Router& router)
+{
+    router.route(whaleroute::rx{".+"})
+            .process(
+                    [](const Request&, Response&, Context& context)
+                    {
+                        context.counter++;
+                    });
+    router.route("/", RequestType::GET).set("Hello world");
+    router.route("/upload", RequestType::POST).set("OK");
+    router.route(whaleroute::rx{R"(/page\d*)"}, RequestType::GET)
+            .process(
+                    [](const Request&, Response& response)
+                    {
+                        response.send("Some page");
+                    });
+    router.route(whaleroute::rx{R"(/chapter/(.+)/page(\d+))"}, RequestType::GET)
+            .process(
+                    [](const std::string& chapterName, int pageIndex, const Request&, Response& response)
+                    {
+                        response.send("Chapter: " + chapterName + ", page[" + std::to_string(pageIndex) + "]");
+                    });
+    router.route(whaleroute::rx{R"(/book-(.+)/chapter/(.+)/page/(\d+))"}, RequestType::GET)
+            .process(
+                    [](const whaleroute::RouteParameters<3>& params, const Request&, Response& response)
+                    {
+                        response.send("Book: " + params.value[0]);
+                    });
+    router.route(whaleroute::rx{R"(/book-(.+)/chapter/(.+))"}, RequestType::GET)
+            .process(
+                    [](const whaleroute::RouteParameters<3>& params, const Request&, Response& response)
+                    {
+                        response.send("Book: " + params.value[0]);
+                    });
+    router.route("/context", RequestType::GET)
+            .process(
+                    [](const Request&, Response& response, Context& context)
+                    {
+                        response.send(std::to_string(context.counter));
+                    });
+    router.route(whaleroute::rx{"/greet/.*"}, RequestType::GET)
+            .process(
+                    [](const Request&, Response& response)
+                    {
+                        response.state->data = "Hello";
+                    });
+    router.route("/greet/world", RequestType::GET)
+            .process(
+                    [](const Request&, Response& response)
+                    {
+                        response.state->data += " world";
+                        response.state->wasSent = true;
+                    });
+    router.route().set("404");
+}
+
+const auto requests = std::vector<Request>{
+        {RequestType::GET, "/", {}},
+        {RequestType::POST, "/", {}},
+        {RequestType::POST, "/upload", {}},
+        {RequestType::GET, "/page123", {}},
+        {RequestType::GET, "/chapter/test/page123", {}},
+        {RequestType::GET, "/book-Hello_world/chapter/test/page/123", {}},
+        {RequestType::GET, "/book-Hello_world/chapter/test/", {}},
+        {RequestType::GET, "/context", {}},
+        {RequestType::GET, "/greet/world", {}},
+        {RequestType::GET, "/greet/moon", {}},
+        {RequestType::GET, "/foo", {}}};
+
+constexpr auto warmUpCount = 3;
+constexpr auto measurementCount = 5;
+
+} // namespace
+
+// Exact allocation counts depend on the standard library implementation,
+// so the tests check that they are stable, balanced and independent of the route table size.
+
+TEST(Allocations, CountingOperators)
+{
+    const auto stats = countAllocations(
+            []
+            {
+                auto value = std::make_unique<int>();
+                auto array = std::make_unique<char[]>(16);
+                [[maybe_unused]] volatile auto valueAddress = value.get();
+                [[maybe_unused]] volatile auto arrayAddress = array.get();
+            });
+    EXPECT_EQ(stats, (AllocationStats{2, 2}));
+}
+
+TEST(Allocations, StableAfterWarmUp)
+{
+    auto router = Router{};
+    registerRoutes(router);
+    for (const auto& request : requests) {
+        auto response = Response{};
+        response.init();
+        auto process = [&]
+        {
+            router.process(request, response);
+        };
+        for (auto i = 0; i < warmUpCount; ++i)
+            process();
+
+        const auto stats = countAllocations(process);
+        EXPECT_EQ(stats.allocationCount, stats.deallocationCount) << request.requestPath;
+        for (auto i = 0; i < measurementCount; ++i)
+            EXPECT_EQ(countAllocations(process), stats) << request.requestPath;
+    }
+}
+
+TEST(Allocations, QueueCreationIsStableAfterWarmUp)
+{
+    auto router = Router{};
+    registerRoutes(router);
+    for (const auto& request : requests) {
+        auto response = Response{};
+        response.init();
+        auto makeQueue = [&]
+        {
+            auto queue = router.makeRequestProcessorQueue(request, response);
+        };
+        auto process = [&]
+        {
+            router.process(request, response);
+        };
+        auto makeAndLaunchQueue = [&]
+        {
+            auto queue = router.makeRequestProcessorQueue(request, response);
+            queue.launch();
+        };
+        for (auto i = 0; i < warmUpCount; ++i)
+            process();
+
+        const auto stats = countAllocations(makeQueue);
+        EXPECT_EQ(stats.allocationCount, stats.deallocationCount) << request.requestPath;
+        for (auto i = 0; i < measurementCount; ++i)
+            EXPECT_EQ(countAllocations(makeQueue), stats) << request.requestPath;
+
+        const auto processStats = countAllocations(process);
+        EXPECT_LE(stats.allocationCount, processStats.allocationCount) << request.requestPath;
+        EXPECT_EQ(countAllocations(makeAndLaunchQueue), processStats) << request.requestPath;
+    }
+}
+
+TEST(Allocations, IndependentOfPathRouteCount)
+{
+    auto smallRouter = Router{};
+    auto largeRouter = Router{};
+    for (auto i = 0; i < 10'000; ++i) {
+        const auto path = "/page/" + std::to_string(i);
+        largeRouter.route(path, RequestType::GET).set(path);
+        if (i % 1000 == 0)
+            smallRouter.route(path, RequestType::GET).set(path);
+    }
+
+    for (const auto& path : {"/page/5000", "/foo"}) {
+        const auto request = Request{RequestType::GET, path, {}};
+        auto countProcessAllocations = [&](Router& router)
+        {
+            auto response = Response{};
+            response.init();
+            auto process = [&]
+            {
+                router.process(request, response);
+            };
+            for (auto i = 0; i < warmUpCount; ++i)
+                process();
+            return countAllocations(process);
+        };
+        EXPECT_EQ(countProcessAllocations(smallRouter), countProcessAllocations(largeRouter)) << path;
+    }
+}
@@ -0,0 +1,138 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <whaleroute/requestrouterhandle.h>
+#include <gtest/gtest.h>
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestType> {
+    bool operator()(RequestType value, const Request& request) const
+    {
+        return value == request.type;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class BatchRouter : public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    int requestPathCount = 0;
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        requestPathCount++;
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+class BatchProcessing : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        router_.route("/", RequestType::GET).set("Hello world");
+        router_.route(whaleroute::rx{R"(/page/(\d+)/?)"})
+                .process(
+                        [](int pageIndex, const Request& request, Response& response)
+                        {
+                            response.send("Page[" + std::to_string(pageIndex) + "]" + request.name);
+                        });
+    }
+
+    std::vector<Request> makeRequests() const
+    {
+        return {Request{RequestType::GET, "/page/1", "A"},
+                Request{RequestType::GET, "/", {}},
+                Request{RequestType::GET, "/page/2", {}},
+                Request{RequestType::GET, "/page/1/", "B"},
+                Request{RequestType::POST, "/", {}},
+                Request{RequestType::GET, "/foo", {}}};
+    }
+
+    std::vector<Response> makeResponses(std::size_t size) const
+    {
+        auto responses = std::vector<Response>(size);
+        for (auto& response : responses)
+            response.init();
+        return responses;
+    }
+
+    static std::vector<std::string> responseData(const std::vector<Response>& responses)
+    {
+        auto result = std::vector<std::string>{};
+        for (const auto& response : responses)
+            result.push_back(response.state->data);
+        return result;
+    }
+
+    const std::vector<std::string> expectedResponseData_ =
+            {"Page[1]A", "Hello world", "Page[2]", "Page[1]B", "", "NO_MATCH"};
+    BatchRouter router_;
+};
+
+} // namespace
+
+TEST_F(BatchProcessing, Process)
+{
+    const auto requests = makeRequests();
+    auto responses = makeResponses(requests.size());
+    router_.process(requests, responses);
+    EXPECT_EQ(responseData(responses), expectedResponseData_);
+    EXPECT_EQ(router_.requestPathCount, static_cast<int>(requests.size()));
+}
+
+TEST_F(BatchProcessing, ProcessWithFrozenRouter)
+{
+    const auto router = router_.freeze();
+    const auto requests = makeRequests();
+    auto responses = makeResponses(requests.size());
+    router.process(requests, responses);
+    EXPECT_EQ(responseData(responses), expectedResponseData_);
+}
+
+TEST_F(BatchProcessing, ProcessWithRouterHandle)
+{
+    const auto routerHandle = whaleroute::RequestRouterHandle<Request, Response, ResponseSender>{router_.freeze()};
+    const auto requests = makeRequests();
+    auto responses = makeResponses(requests.size());
+    routerHandle.process(requests, responses);
+    EXPECT_EQ(responseData(responses), expectedResponseData_);
+}
+
+TEST_F(BatchProcessing, QueuesLaunchedSeparately)
+{
+    const auto requests = makeRequests();
+    auto responses = makeResponses(requests.size());
+    auto queues = router_.makeRequestProcessorQueues(requests, responses);
+    ASSERT_EQ(queues.size(), requests.size());
+
+    queues[2].launch();
+    EXPECT_EQ(responseData(responses), (std::vector<std::string>{"", "", "Page[2]", "", "", ""}));
+    for (auto& queue : queues)
+        queue.launch();
+    EXPECT_EQ(responseData(responses), expectedResponseData_);
+}
+
+TEST_F(BatchProcessing, EmptyBatch)
+{
+    auto responses = std::vector<Response>{};
+    EXPECT_TRUE(router_.makeRequestProcessorQueues({}, responses).empty());
+}
@@ -0,0 +1,124 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestType> {
+    bool operator()(RequestType value, const Request& request) const
+    {
+        return value == request.type;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class BulkRouteRegistration : public ::testing::Test,
+                              public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    std::string processRequest(const std::string& path, RequestType requestType = RequestType::GET)
+    {
+        auto response = Response{};
+        response.init();
+        process(Request{requestType, path, {}}, response);
+        return response.state->data;
+    }
+
+    static std::function<void(RouteSpec::Route&)> sendText(const std::string& text)
+    {
+        return [text](RouteSpec::Route& route)
+        {
+            route.set(text);
+        };
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+} // namespace
+
+TEST_F(BulkRouteRegistration, AddRoutes)
+{
+    const auto routeSpecs = std::vector<RouteSpec>{
+            {"/", {RequestType::GET}, sendText("Hello world")},
+            {"/", {RequestType::POST}, sendText("Posted")},
+            {whaleroute::rx{R"(/page/(\d+))"},
+             {},
+             [](RouteSpec::Route& route)
+             {
+                 route.process(
+                         [](int pageIndex, const Request&)
+                         {
+                             return "Page[" + std::to_string(pageIndex) + "]";
+                         });
+             }},
+            {"/about", {}, sendText("About")}};
+    EXPECT_TRUE(addRoutes(routeSpecs).empty());
+    route("/contacts").set("Contacts");
+
+    EXPECT_EQ(processRequest("/"), "Hello world");
+    EXPECT_EQ(processRequest("/", RequestType::POST), "Posted");
+    EXPECT_EQ(processRequest("/page/42"), "Page[42]");
+    EXPECT_EQ(processRequest("/about/"), "About");
+    EXPECT_EQ(processRequest("/contacts"), "Contacts");
+    EXPECT_EQ(processRequest("/foo"), "NO_MATCH");
+
+    const auto analysis = analyzeRoutes();
+    EXPECT_TRUE(analysis.shadowedRoutes.empty());
+    EXPECT_EQ(analysis.worstCaseComparisons, 2u);
+}
+
+TEST_F(BulkRouteRegistration, InvalidAndDuplicateRoutes)
+{
+    const auto routeSpecs = std::vector<RouteSpec>{
+            {"/", {}, sendText("Hello world")},
+            {"", {}, sendText("Empty")},
+            {whaleroute::rx{""}, {}, sendText("Empty")},
+            {"/about", {}, {}},
+            {"/", {}, sendText("Duplicate")},
+            {"/", {RequestType::GET}, sendText("GET")},
+            {whaleroute::rx{"/page/.*"}, {}, sendText("Page")},
+            {whaleroute::rx{"/page/.*/"}, {}, sendText("Duplicate page")},
+            {"/contacts", {}, sendText("Contacts")}};
+    const auto errors = addRoutes(routeSpecs);
+    ASSERT_EQ(errors.size(), 5u);
+    EXPECT_EQ(errors[0].specIndex, 1u);
+    EXPECT_EQ(errors[0].type, whaleroute::RouteSpecErrorType::EmptyPath);
+    EXPECT_EQ(errors[1].specIndex, 2u);
+    EXPECT_EQ(errors[1].type, whaleroute::RouteSpecErrorType::EmptyPath);
+    EXPECT_EQ(errors[2].specIndex, 3u);
+    EXPECT_EQ(errors[2].type, whaleroute::RouteSpecErrorType::NoProcessors);
+    EXPECT_EQ(errors[3].specIndex, 4u);
+    EXPECT_EQ(errors[3].type, whaleroute::RouteSpecErrorType::DuplicateRoute);
+    EXPECT_EQ(errors[4].specIndex, 7u);
+    EXPECT_EQ(errors[4].type, whaleroute::RouteSpecErrorType::DuplicateRoute);
+
+    EXPECT_EQ(processRequest("/"), "Hello world");
+    EXPECT_EQ(processRequest("/page/1"), "Page");
+    EXPECT_EQ(processRequest("/about"), "NO_MATCH");
+    EXPECT_EQ(processRequest("/contacts"), "Contacts");
+    EXPECT_EQ(analyzeRoutes().worstCaseComparisons, 2u);
+    EXPECT_THROW(routeById(4), std::out_of_range);
+}
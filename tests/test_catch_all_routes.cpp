@@ -0,0 +1,116 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class CatchAllRoutes : public ::testing::Test,
+                       public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    std::string processRequest(const std::string& path)
+    {
+        auto response = Response{};
+        response.init();
+        process(Request{RequestType::GET, path, {}}, response);
+        return response.state->context + response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+
+    static auto sendParam(const std::string& name)
+    {
+        return [name](const std::string& param, const Request&)
+        {
+            return name + "[" + param + "]";
+        };
+    }
+};
+
+} // namespace
+
+TEST_F(CatchAllRoutes, MatchPrefix)
+{
+    route("/static/*rest").process(sendParam("Static"));
+    route("/static/css/*").process(sendParam("Css"));
+    route("/proxy/*path").process(
+            [](const whaleroute::RouteParameters<>& params, const Request&)
+            {
+                return "Proxy[" + params.value.at(0) + "]";
+            });
+    route("/about").set("About");
+
+    EXPECT_EQ(processRequest("/static/js/app.js"), "Static[js/app.js]");
+    EXPECT_EQ(processRequest("/static/css/style.css"), "Static[css/style.css]");
+    EXPECT_EQ(processRequest("/static/"), "Static[]");
+    EXPECT_EQ(processRequest("/static"), "Static[]");
+    EXPECT_EQ(processRequest("/staticfile"), "NO_MATCH");
+    EXPECT_EQ(processRequest("/proxy/api/v1/users/"), "Proxy[api/v1/users]");
+    EXPECT_EQ(processRequest("/about"), "About");
+    EXPECT_EQ(processRequest("/about/*"), "NO_MATCH");
+}
+
+TEST_F(CatchAllRoutes, RegistrationOrderIsPreserved)
+{
+    setTrailingSlashMode(whaleroute::TrailingSlashMode::Strict);
+    route("/*path").process(
+            [](const std::string& path, const Request&, Response& response)
+            {
+                response.state->context += "log(" + path + ");";
+            });
+    route(whaleroute::rx{"/files/(.*)"})
+            .process(
+                    [](const std::string& path, const Request&, Response& response)
+                    {
+                        response.state->context += "rx(" + path + ");";
+                    });
+    route("/files/*rest").process(
+            [](const std::string& path, const Request&, Response& response)
+            {
+                response.state->context += "files(" + path + ");";
+            });
+    route("/files/readme.txt").set("Readme");
+    route("/files/*rest").process(sendParam("File"));
+
+    EXPECT_EQ(processRequest("/files/readme.txt"), "log(files/readme.txt);rx(readme.txt);files(readme.txt);Readme");
+    EXPECT_EQ(processRequest("/files/a/"), "log(files/a/);rx(a/);files(a/);File[a/]");
+    EXPECT_EQ(processRequest("/other"), "log(other);");
+}
+
+TEST_F(CatchAllRoutes, RouteAnalysis)
+{
+    route("/static/*rest").set("Static");
+    route("/static/css/*rest").set("Css");
+    route("/static/index.html").set("Index");
+    route(whaleroute::rx{"/static/about"}).set("About");
+    route("/staticfile").set("File");
+
+    const auto analysis = analyzeRoutes();
+    ASSERT_EQ(analysis.shadowedRoutes.size(), 3u);
+    EXPECT_EQ(analysis.shadowedRoutes[0].routeIndex, 1u);
+    EXPECT_EQ(analysis.shadowedRoutes[0].shadowingRouteIndex, 0u);
+    EXPECT_EQ(analysis.shadowedRoutes[1].routeIndex, 2u);
+    EXPECT_EQ(analysis.shadowedRoutes[1].shadowingRouteIndex, 0u);
+    EXPECT_EQ(analysis.shadowedRoutes[2].routeIndex, 3u);
+    EXPECT_EQ(analysis.shadowedRoutes[2].shadowingRouteIndex, 0u);
+}
@@ -0,0 +1,158 @@
+#include <whaleroute/task.h>
+#ifdef __cpp_impl_coroutine
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <coroutine>
+
+namespace {
+
+struct Context {
+    std::string value;
+};
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+// Suspends the coroutine until resume() is called
+class ManualEvent {
+public:
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) noexcept
+    {
+        handle_ = handle;
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+    bool isAwaited() const
+    {
+        return static_cast<bool>(handle_);
+    }
+
+    void resume()
+    {
+        std::exchange(handle_, {}).resume();
+    }
+
+private:
+    std::coroutine_handle<> handle_;
+};
+
+class CoroutineRouter : public ::testing::Test,
+                        public whaleroute::RequestRouter<Request, Response, ResponseSender, Context> {
+public:
+    whaleroute::RequestProcessorQueue launchRequest(const std::string& path)
+    {
+        response_.init();
+        auto queue = makeRequestProcessorQueue(Request{RequestType::GET, path, {}}, response_);
+        queue.launch();
+        return queue;
+    }
+
+    void checkResponse(const std::string& expectedResponseData)
+    {
+        EXPECT_EQ(response_.state->data, expectedResponseData);
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+
+protected:
+    Response response_;
+    ManualEvent event_;
+};
+
+whaleroute::Task<std::string> readName(ManualEvent& event, std::string name)
+{
+    co_await event;
+    co_return name;
+}
+
+} // namespace
+
+TEST_F(CoroutineRouter, CompletedWithoutSuspension)
+{
+    route("/")
+            .process(
+                    [](const Request&, Response& response) -> whaleroute::Task<>
+                    {
+                        response.send("Hello world");
+                        co_return;
+                    });
+    launchRequest("/");
+    checkResponse("Hello world");
+}
+
+TEST_F(CoroutineRouter, ResumedOnCompletion)
+{
+    route(whaleroute::rx{".*"})
+            .process(
+                    [this](const Request&, Response&, Context& context) -> whaleroute::Task<>
+                    {
+                        context.value = co_await readName(event_, "world");
+                    });
+    route(whaleroute::rx{"/greet/(.+)"})
+            .process(
+                    [](const std::string& greeting, const Request&, const Context& context)
+                            -> whaleroute::Task<std::string>
+                    {
+                        co_return greeting + " " + context.value;
+                    });
+    route().set("404");
+
+    auto queue = launchRequest("/greet/Hello");
+    ASSERT_TRUE(event_.isAwaited());
+    checkResponse("");
+
+    queue = {};
+    event_.resume();
+    checkResponse("Hello world");
+}
+
+TEST_F(CoroutineRouter, StoppedQueueIsntResumedOnCompletion)
+{
+    route("/")
+            .process(
+                    [this](const Request&, Response& response) -> whaleroute::Task<>
+                    {
+                        response.state->data = co_await readName(event_, "Hello");
+                    })
+            .process(
+                    [](const Request&, Response& response)
+                    {
+                        response.send(response.state->data + " world");
+                    });
+
+    auto queue = launchRequest("/");
+    queue.stop();
+    event_.resume();
+    checkResponse("Hello");
+
+    queue.launch();
+    checkResponse("Hello world");
+}
+#endif
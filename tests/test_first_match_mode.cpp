@@ -0,0 +1,126 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestType> {
+    bool operator()(RequestType value, const Request& request) const
+    {
+        return value == request.type;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class TestRouter : public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    std::string processRequest(const std::string& path, RequestType requestType = RequestType::GET)
+    {
+        auto response = Response{};
+        response.init();
+        process(Request{requestType, path, {}}, response);
+        return response.state->context + response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+auto sendParams(const std::string& name)
+{
+    return [name](const whaleroute::RouteParameters<>& params, const Request&)
+    {
+        auto result = name + "[";
+        for (const auto& param : params.value)
+            result += param + ";";
+        return result + "]";
+    };
+}
+
+} // namespace
+
+TEST(FirstMatchMode, RoutesAreRankedBySpecificity)
+{
+    auto router = TestRouter{};
+    router.setMatchingMode(whaleroute::MatchingMode::FirstMatch);
+    router.route(whaleroute::rx{"/files/(.*)"}).process(sendParams("Regex"));
+    router.route("/files/*rest").process(sendParams("Files"));
+    router.route("/files/docs/*rest").process(sendParams("Docs"));
+    router.route(whaleroute::rx{R"(/files/(\d+))"}).process(sendParams("Template"));
+    router.group("/api").route(whaleroute::rx{R"(/files/(\d+))"}).process(sendParams("ApiTemplate"));
+    router.route(whaleroute::rx{"/api/files/.*"}).process(sendParams("ApiRegex"));
+    router.route("/files/readme.txt").set("Readme");
+    router.route(whaleroute::rx{"/images/(.*)"}).process(sendParams("Images"));
+
+    EXPECT_EQ(router.processRequest("/files/readme.txt"), "Readme");
+    EXPECT_EQ(router.processRequest("/files/42"), "Template[42;]");
+    EXPECT_EQ(router.processRequest("/files/docs/a/b.txt"), "Docs[a/b.txt;]");
+    EXPECT_EQ(router.processRequest("/files/docs"), "Docs[;]");
+    EXPECT_EQ(router.processRequest("/files/a/b.txt"), "Files[a/b.txt;]");
+    EXPECT_EQ(router.processRequest("/api/files/42"), "ApiTemplate[42;]");
+    EXPECT_EQ(router.processRequest("/api/files/a"), "ApiRegex[]");
+    EXPECT_EQ(router.processRequest("/images/logo.png"), "Images[logo.png;]");
+    EXPECT_EQ(router.processRequest("/about"), "NO_MATCH");
+}
+
+TEST(FirstMatchMode, RoutesWithTheSamePathAreProcessedInRegistrationOrder)
+{
+    auto router = TestRouter{};
+    router.setMatchingMode(whaleroute::MatchingMode::FirstMatch);
+    router.route(whaleroute::rx{".*"}).set("Fallback");
+    router.route("/", RequestType::GET).set("Get");
+    router.route("/").process(
+            [](const Request&, Response& response)
+            {
+                response.state->context += "log;";
+            });
+    router.route("/", RequestType::POST).set("Post");
+
+    EXPECT_EQ(router.processRequest("/"), "Get");
+    EXPECT_EQ(router.processRequest("/", RequestType::POST), "log;Post");
+    EXPECT_EQ(router.processRequest("/about"), "Fallback");
+
+    const auto frozenRouter = router.freeze();
+    auto response = Response{};
+    response.init();
+    frozenRouter.process(Request{RequestType::POST, "/", {}}, response);
+    EXPECT_EQ(response.state->context + response.state->data, "log;Post");
+}
+
+TEST(FirstMatchMode, MountedRouters)
+{
+    auto usersRouter = TestRouter{};
+    usersRouter.route(whaleroute::rx{".*"}).set("Users");
+
+    auto router = TestRouter{};
+    router.setMatchingMode(whaleroute::MatchingMode::FirstMatch);
+    router.route("/*rest").process(sendParams("Root"));
+    router.mount("/api/users", usersRouter);
+    router.route("/api/users/me").set("Me");
+
+    EXPECT_EQ(router.processRequest("/api/users/me"), "Me");
+    EXPECT_EQ(router.processRequest("/api/users/42"), "Users");
+    EXPECT_EQ(router.processRequest("/api/books"), "Root[api/books;]");
+}
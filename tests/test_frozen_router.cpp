@@ -0,0 +1,213 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+struct Context {
+    int counter = 0;
+};
+
+} // namespace
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestType, Context> {
+    bool operator()(const RequestType& value, const Request& request, const Context&) const
+    {
+        return value == request.type;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class FrozenRouter : public ::testing::Test,
+                     public whaleroute::RequestRouter<Request, Response, ResponseSender, Context> {
+public:
+    template<typename TRouter>
+    static std::string processRequest(
+            TRouter& router,
+            const std::string& path,
+            RequestType requestType = RequestType::GET)
+    {
+        auto response = Response{};
+        response.init();
+        router.process(Request{requestType, path, {}}, response);
+        return response.state->data;
+    }
+
+    void onRouteParametersError(const Request&, Response& response, const whaleroute::RouteParameterError& error)
+            override
+    {
+        response.send(getRouteParamErrorInfo(error));
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+struct PageProcessor {
+    std::string operator()(int pageIndex, const Request&) const
+    {
+        return "Page[" + std::to_string(pageIndex) + "]";
+    }
+};
+
+struct IncrementContext {
+    void operator()(const Request&, Response&, Context& context) const
+    {
+        context.counter++;
+    }
+};
+
+class CounterProcessor {
+public:
+    CounterProcessor(std::string prefix)
+        : prefix_{std::move(prefix)}
+    {
+    }
+
+    std::string operator()(const Request&)
+    {
+        return prefix_ + std::to_string(++counter_);
+    }
+
+private:
+    std::string prefix_;
+    int counter_ = 0;
+};
+
+void registerRoutes(whaleroute::RequestRouter<Request, Response, ResponseSender, Context>& router)
+{
+    router.route(whaleroute::rx{".+"}).process<IncrementContext>();
+    router.route("/", RequestType::GET).set("Hello world");
+    router.route("/upload", RequestType::POST).set("OK");
+    router.route(whaleroute::rx{R"(/page/(\d+))"}, RequestType::GET).process<PageProcessor>();
+    router.route("/context", RequestType::GET)
+            .process(
+                    [](const Request&, const Context& context)
+                    {
+                        return std::to_string(context.counter);
+                    });
+    router.route().set("404");
+}
+
+} // namespace
+
+TEST_F(FrozenRouter, Matching)
+{
+    registerRoutes(*this);
+    const auto router = freeze();
+
+    EXPECT_EQ(processRequest(router, "/"), "Hello world");
+    EXPECT_EQ(processRequest(router, "/", RequestType::POST), "404");
+    EXPECT_EQ(processRequest(router, "/upload", RequestType::POST), "OK");
+    EXPECT_EQ(processRequest(router, "/page/42"), "Page[42]");
+    EXPECT_EQ(processRequest(router, "/page/foo"), "404");
+    EXPECT_EQ(processRequest(router, "/context"), "1");
+    EXPECT_EQ(processRequest(router, "/foo"), "404");
+}
+
+TEST_F(FrozenRouter, NotAffectedByLaterRegistrations)
+{
+    route("/", RequestType::GET).set("Hello world");
+    auto& route = this->route("/foo");
+    const auto router = freeze();
+
+    this->route("/bar").set("Bar");
+    route.set("Foo");
+
+    EXPECT_EQ(processRequest(router, "/"), "Hello world");
+    EXPECT_EQ(processRequest(router, "/foo"), "NO_MATCH");
+    EXPECT_EQ(processRequest(router, "/bar"), "NO_MATCH");
+
+    EXPECT_EQ(processRequest(*this, "/foo"), "Foo");
+    EXPECT_EQ(processRequest(*this, "/bar"), "Bar");
+}
+
+TEST_F(FrozenRouter, QueueOutlivesFrozenRouter)
+{
+    route("/", RequestType::GET).set("Hello world");
+    auto response = Response{};
+    response.init();
+    auto queue = freeze().makeRequestProcessorQueue(Request{RequestType::GET, "/", {}}, response);
+    queue.launch();
+    EXPECT_EQ(response.state->data, "Hello world");
+}
+
+TEST_F(FrozenRouter, ConcurrentProcessing)
+{
+    registerRoutes(*this);
+    const auto router = freeze();
+
+    const auto threadCount = 16;
+    const auto requestCount = 500;
+    auto errorCount = std::atomic<int>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+        threads.emplace_back(
+                [&, threadIndex]
+                {
+                    for (auto i = 0; i < requestCount; ++i) {
+                        const auto pageIndex = std::to_string(threadIndex * requestCount + i);
+                        if (processRequest(router, "/page/" + pageIndex) != "Page[" + pageIndex + "]")
+                            errorCount++;
+                        if (processRequest(router, "/") != "Hello world")
+                            errorCount++;
+                        if (processRequest(router, "/context") != "1")
+                            errorCount++;
+                        if (processRequest(router, "/foo") != "404")
+                            errorCount++;
+                    }
+                });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(errorCount, 0);
+}
+
+TEST_F(FrozenRouter, ConcurrentProcessingWithPerThreadProcessors)
+{
+    route("/counter", RequestType::GET).processPerThread<CounterProcessor>("Counter: ");
+    const auto router = freeze();
+
+    const auto threadCount = 16;
+    const auto requestCount = 500;
+    auto errorCount = std::atomic<int>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+        threads.emplace_back(
+                [&]
+                {
+                    for (auto i = 1; i <= requestCount; ++i)
+                        if (processRequest(router, "/counter") != "Counter: " + std::to_string(i))
+                            errorCount++;
+                });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(errorCount, 0);
+}
@@ -0,0 +1,126 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+
+namespace {
+int nameCheckCount = 0;
+
+struct RequestName {
+    std::string value;
+};
+} // namespace
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestName> {
+    bool operator()(const RequestName& name, const Request& request) const
+    {
+        ++nameCheckCount;
+        return name.value == request.name;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class TestRouter : public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    std::string processRequest(const std::string& path, const std::string& name = {})
+    {
+        auto response = Response{};
+        response.init();
+        process(Request{RequestType::GET, path, name}, response);
+        return response.state->context + response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+auto addContext(const std::string& value)
+{
+    return [value](const Request&, Response& response)
+    {
+        response.state->context += value + ";";
+    };
+}
+
+} // namespace
+
+TEST(IncrementalMatching, RoutesAfterFinishedRouteAreNotMatched)
+{
+    auto router = TestRouter{};
+    router.enableRouteStatistics();
+    router.route(whaleroute::rx{"/.*"}).process(addContext("log"));
+    router.route("/").set("Index");
+    router.route(whaleroute::rx{"/.*"}, RequestName{"admin"}).set("Admin");
+    router.route(whaleroute::rx{"/page/.*"}).set("Page");
+
+    nameCheckCount = 0;
+    EXPECT_EQ(router.processRequest("/", "admin"), "log;Index");
+    EXPECT_EQ(nameCheckCount, 0);
+    EXPECT_EQ(router.processRequest("/page/1", "admin"), "log;Admin");
+    EXPECT_EQ(nameCheckCount, 1);
+    EXPECT_EQ(router.processRequest("/page/1", "guest"), "log;Page");
+    EXPECT_EQ(nameCheckCount, 2);
+    EXPECT_EQ(router.processRequest("/about", "guest"), "log;");
+
+    const auto statistics = router.routeStatistics();
+    ASSERT_EQ(statistics.size(), 4u);
+    EXPECT_EQ(statistics[0].matchCount, 4u);
+    EXPECT_EQ(statistics[1].matchCount, 1u);
+    EXPECT_EQ(statistics[2].matchCount, 3u);
+    EXPECT_EQ(statistics[3].matchCount, 1u);
+}
+
+TEST(IncrementalMatching, UnmatchedRequestProcessors)
+{
+    auto router = TestRouter{};
+    router.route("/").process(addContext("index"));
+    router.route(whaleroute::rx{"/page/.*"}).set("Page");
+    router.route().set("Not found");
+
+    EXPECT_EQ(router.processRequest("/"), "index;Not found");
+    EXPECT_EQ(router.processRequest("/page/1"), "Page");
+    EXPECT_EQ(router.processRequest("/about"), "Not found");
+}
+
+TEST(IncrementalMatching, FrozenRouterWithMountedRouter)
+{
+    auto apiRouter = TestRouter{};
+    apiRouter.route(whaleroute::rx{"/.*"}).process(addContext("api"));
+    apiRouter.route("/status").set("Status");
+
+    auto router = TestRouter{};
+    router.route(whaleroute::rx{".*"}).process(addContext("log"));
+    router.mount("/api", apiRouter);
+    router.route("/api/status").set("Old status");
+    router.route(whaleroute::rx{".*"}).set("Fallback");
+    const auto frozenRouter = router.freeze();
+
+    auto response = Response{};
+    response.init();
+    frozenRouter.process(Request{RequestType::GET, "/api/status", {}}, response);
+    EXPECT_EQ(response.state->context + response.state->data, "log;api;Status");
+    EXPECT_EQ(router.processRequest("/api/version"), "log;api;Fallback");
+}
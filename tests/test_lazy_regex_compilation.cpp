@@ -0,0 +1,123 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class LazyRegexCompilation : public ::testing::Test,
+                             public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    template<typename TRouter>
+    static std::string processRequest(TRouter& router, const std::string& path)
+    {
+        auto response = Response{};
+        response.init();
+        router.process(Request{RequestType::GET, path, {}}, response);
+        return response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+} // namespace
+
+TEST(LazyRegex, CompiledOnFirstUse)
+{
+    const auto regExp = whaleroute::detail::LazyRegex{R"(/page/(\d+))"};
+    EXPECT_FALSE(regExp.isCompiled());
+    EXPECT_TRUE(std::regex_match("/page/1", regExp.get()));
+    EXPECT_TRUE(regExp.isCompiled());
+    EXPECT_FALSE(std::regex_match("/page/foo", regExp.get()));
+}
+
+TEST(LazyRegex, InvalidPattern)
+{
+    const auto regExp = whaleroute::detail::LazyRegex{"/page/("};
+    EXPECT_THROW(regExp.get(), std::regex_error);
+    EXPECT_FALSE(regExp.isCompiled());
+    EXPECT_THROW(regExp.get(), std::regex_error);
+}
+
+TEST_F(LazyRegexCompilation, InvalidPatternIsReportedOnFirstMatch)
+{
+    route("/").set("Hello world");
+    EXPECT_NO_THROW(route(whaleroute::rx{"/page/("}).set("Page"));
+    EXPECT_THROW(warmUp(), std::regex_error);
+    EXPECT_EQ(processRequest(*this, "/"), "Hello world");
+    EXPECT_THROW(processRequest(*this, "/page"), std::regex_error);
+}
+
+TEST_F(LazyRegexCompilation, IdenticalPatterns)
+{
+    route(whaleroute::rx{R"(/page/(\d+))"})
+            .process(
+                    [](int pageIndex, const Request&, Response& response)
+                    {
+                        response.state->data = "Page[" + std::to_string(pageIndex) + "]";
+                    });
+    route(whaleroute::rx{R"(/page/(\d+)/)"})
+            .process(
+                    [](int pageIndex, const Request&, Response& response)
+                    {
+                        response.send(response.state->data + "#" + std::to_string(pageIndex));
+                    });
+    warmUp();
+    EXPECT_EQ(processRequest(*this, "/page/1"), "Page[1]#1");
+    EXPECT_EQ(processRequest(*this, "/page/2/"), "Page[2]#2");
+    EXPECT_EQ(processRequest(*this, "/page/foo"), "NO_MATCH");
+}
+
+TEST_F(LazyRegexCompilation, ConcurrentCompilationWithFrozenRouter)
+{
+    for (auto i = 0; i < 100; ++i)
+        route(whaleroute::rx{"/page" + std::to_string(i) + R"(/(\d+))"})
+                .process(
+                        [i](int pageIndex, const Request&)
+                        {
+                            return std::to_string(i) + ":" + std::to_string(pageIndex);
+                        });
+    const auto router = freeze();
+
+    const auto threadCount = 8;
+    auto errorCount = std::atomic<int>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+        threads.emplace_back(
+                [&, threadIndex]
+                {
+                    for (auto i = 0; i < 100; ++i) {
+                        const auto routeIndex = (i + threadIndex * 10) % 100;
+                        const auto path = "/page" + std::to_string(routeIndex) + "/" + std::to_string(threadIndex);
+                        if (processRequest(router, path) !=
+                            std::to_string(routeIndex) + ":" + std::to_string(threadIndex))
+                            errorCount++;
+                    }
+                });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(errorCount, 0);
+}
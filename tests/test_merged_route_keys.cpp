@@ -0,0 +1,119 @@
+#include "common.h"
+#include "threadpool.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+struct Context {
+    std::string value;
+};
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class MergedRouteKeys : public ::testing::Test,
+                        public whaleroute::RequestRouter<Request, Response, ResponseSender, Context> {
+public:
+    std::string processRequest(const std::string& path)
+    {
+        auto response = Response{};
+        response.init();
+        process(Request{RequestType::GET, path, {}}, response);
+        return response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+
+    static auto addValue(const std::string& value)
+    {
+        return [value](const Request&, Response&, Context& context)
+        {
+            context.value += value + ";";
+        };
+    }
+
+    static auto addParamValue(const std::string& value)
+    {
+        return [value](const std::string& param, const Request&, Response&, Context& context)
+        {
+            context.value += value + "(" + param + ");";
+        };
+    }
+
+    void registerRoutes()
+    {
+        route("/a").process(addValue("auth"));
+        route(whaleroute::rx{"/(.*)"}).process(addParamValue("log"));
+        route(whaleroute::rx{"/(b)"}).process(addParamValue("b"));
+        route("/a").process(addValue("handler"));
+        route(whaleroute::rx{"/(.*)"}).process(addParamValue("metrics"));
+        route(whaleroute::rx{"/(b)/"}).process(addParamValue("b2"));
+        route("/a/").process(addValue("a2"));
+        route(whaleroute::rx{".*"})
+                .process(
+                        [](const Request&, Response& response, const Context& context)
+                        {
+                            response.send(context.value);
+                        });
+    }
+};
+
+} // namespace
+
+TEST_F(MergedRouteKeys, RegistrationOrderIsPreserved)
+{
+    registerRoutes();
+    EXPECT_EQ(processRequest("/a"), "auth;log(a);handler;metrics(a);a2;");
+    EXPECT_EQ(processRequest("/b"), "log(b);b(b);metrics(b);b2(b);");
+    EXPECT_EQ(processRequest("/c/"), "log(c);metrics(c);");
+    EXPECT_EQ(analyzeRoutes().worstCaseComparisons, 4u);
+}
+
+TEST_F(MergedRouteKeys, RegistrationOrderIsPreservedWithParallelMatching)
+{
+    auto threadPool = ThreadPool{2};
+    enableParallelMatching(threadPool, 2, 2);
+    registerRoutes();
+    EXPECT_EQ(processRequest("/a"), "auth;log(a);handler;metrics(a);a2;");
+    EXPECT_EQ(processRequest("/b"), "log(b);b(b);metrics(b);b2(b);");
+    const auto router = freeze();
+    auto response = Response{};
+    response.init();
+    router.process(Request{RequestType::GET, "/b", {}}, response);
+    EXPECT_EQ(response.state->data, "log(b);b(b);metrics(b);b2(b);");
+}
+
+TEST_F(MergedRouteKeys, RouteStatisticsAreCollectedPerRegistration)
+{
+    enableRouteStatistics();
+    registerRoutes();
+    processRequest("/a");
+    processRequest("/b");
+    const auto statistics = routeStatistics();
+    ASSERT_EQ(statistics.size(), 8u);
+    EXPECT_EQ(statistics[0].matchCount, 1u);
+    EXPECT_EQ(statistics[1].matchCount, 2u);
+    EXPECT_EQ(statistics[2].matchCount, 1u);
+    EXPECT_EQ(statistics[4].matchCount, 2u);
+    EXPECT_EQ(statistics[5].matchCount, 1u);
+    EXPECT_EQ(statistics[6].matchCount, 1u);
+}
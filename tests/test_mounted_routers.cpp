@@ -0,0 +1,142 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestType> {
+    bool operator()(RequestType value, const Request& request) const
+    {
+        return value == request.type;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class TestRouter : public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    explicit TestRouter(std::string unmatchedResponse = "NO_MATCH")
+        : unmatchedResponse_{std::move(unmatchedResponse)}
+    {
+    }
+
+    std::string processRequest(const std::string& path, RequestType requestType = RequestType::GET)
+    {
+        auto response = Response{};
+        response.init();
+        process(Request{requestType, path, {}}, response);
+        return response.state->context + response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send(unmatchedResponse_);
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+
+private:
+    std::string unmatchedResponse_;
+};
+
+auto addContext(const std::string& value)
+{
+    return [value](const Request&, Response& response)
+    {
+        response.state->context += value + ";";
+    };
+}
+
+} // namespace
+
+TEST(MountedRouters, MountRouter)
+{
+    auto usersRouter = TestRouter{"USERS_NO_MATCH"};
+    usersRouter.route("/", RequestType::GET).set("Users");
+    usersRouter.route("/", RequestType::POST).set("New user");
+    usersRouter.route(whaleroute::rx{R"(/(\d+))"})
+            .process(
+                    [](int userId, const Request&)
+                    {
+                        return "User[" + std::to_string(userId) + "]";
+                    });
+
+    auto router = TestRouter{};
+    router.route("/").set("Index");
+    router.mount("/api/users/", usersRouter);
+
+    EXPECT_EQ(router.processRequest("/"), "Index");
+    EXPECT_EQ(router.processRequest("/api/users"), "Users");
+    EXPECT_EQ(router.processRequest("/api/users/"), "Users");
+    EXPECT_EQ(router.processRequest("/api/users", RequestType::POST), "New user");
+    EXPECT_EQ(router.processRequest("/api/users/42"), "User[42]");
+    EXPECT_EQ(router.processRequest("/api/users/foo"), "NO_MATCH");
+    EXPECT_EQ(router.processRequest("/api/users42"), "NO_MATCH");
+    EXPECT_EQ(router.processRequest("/api"), "NO_MATCH");
+
+    usersRouter.route("/me").set("Me");
+    EXPECT_EQ(router.processRequest("/api/users/me"), "Me");
+}
+
+TEST(MountedRouters, RegistrationOrderIsPreserved)
+{
+    auto apiRouter = TestRouter{};
+    apiRouter.route(whaleroute::rx{"/.*"}).process(addContext("api"));
+    apiRouter.route("/status").set("Status");
+
+    auto nestedRouter = TestRouter{};
+    nestedRouter.route("/").set("Nested");
+    apiRouter.mount("/nested", nestedRouter);
+
+    auto router = TestRouter{};
+    router.route(whaleroute::rx{".*"}).process(addContext("log"));
+    router.mount("/api", apiRouter);
+    router.route("/api/status").process(addContext("after"));
+    router.route("/api/version").set("Version");
+    router.mount("/", apiRouter);
+
+    EXPECT_EQ(router.processRequest("/api/status"), "log;api;Status");
+    EXPECT_EQ(router.processRequest("/api/nested"), "log;api;Nested");
+    EXPECT_EQ(router.processRequest("/api/version"), "log;api;Version");
+    EXPECT_EQ(router.processRequest("/status"), "log;api;Status");
+    EXPECT_EQ(router.processRequest("/nested/"), "log;api;Nested");
+}
+
+TEST(MountedRouters, FrozenRouter)
+{
+    auto usersRouter = TestRouter{};
+    usersRouter.route("/").set("Users");
+
+    auto router = TestRouter{};
+    router.mount("/users", usersRouter);
+    const auto frozenRouter = router.freeze();
+    usersRouter.route("/me").set("Me");
+
+    auto processRequest = [&](const std::string& path)
+    {
+        auto response = Response{};
+        response.init();
+        frozenRouter.process(Request{RequestType::GET, path, {}}, response);
+        return response.state->data;
+    };
+    EXPECT_EQ(processRequest("/users"), "Users");
+    EXPECT_EQ(processRequest("/users/me"), "NO_MATCH");
+    EXPECT_EQ(router.processRequest("/users/me"), "Me");
+}
@@ -0,0 +1,212 @@
+#include "common.h"
+#include "threadpool.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace {
+
+struct Context {
+    std::string value;
+};
+
+} // namespace
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestType, Context> {
+    bool operator()(const RequestType& value, const Request& request, const Context&) const
+    {
+        return value == request.type;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+// Stores the posted tasks until run() is called
+class ManualExecutor {
+public:
+    void post(std::function<void()> task)
+    {
+        tasks_.push_back(std::move(task));
+    }
+
+    std::size_t taskCount() const
+    {
+        return tasks_.size();
+    }
+
+    void run()
+    {
+        while (!tasks_.empty()) {
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            task();
+        }
+    }
+
+private:
+    std::deque<std::function<void()>> tasks_;
+};
+
+class OffloadedProcessors : public ::testing::Test,
+                            public whaleroute::RequestRouter<Request, Response, ResponseSender, Context> {
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+
+    void registerRoutes()
+    {
+        route(whaleroute::rx{"/.*"}, RequestType::GET)
+                .process(
+                        [](const Request&, Response&, Context& context)
+                        {
+                            context.value += "A";
+                        });
+        route(whaleroute::rx{"/(.*)"}, RequestType::GET)
+                .processOffloaded(
+                        [](const std::string& name, const Request&, Response&, Context& context)
+                        {
+                            context.value += "B(" + name + ")";
+                        });
+        route(whaleroute::rx{"/.*"}, RequestType::POST)
+                .processOffloaded(
+                        [](const Request&, Response&, Context& context)
+                        {
+                            context.value += "C";
+                        });
+        route(whaleroute::rx{"/.*"})
+                .process(
+                        [](const Request&, Response& response, const Context& context)
+                        {
+                            response.send(context.value);
+                        });
+    }
+};
+
+} // namespace
+
+TEST_F(OffloadedProcessors, InvokedInlineWithoutExecutor)
+{
+    registerRoutes();
+    auto response = Response{};
+    response.init();
+    process(Request{RequestType::GET, "/foo", {}}, response);
+    EXPECT_EQ(response.state->data, "AB(foo)");
+}
+
+TEST_F(OffloadedProcessors, PostedToExecutor)
+{
+    registerRoutes();
+    auto executor = ManualExecutor{};
+    auto response = Response{};
+    response.init();
+    process(Request{RequestType::GET, "/foo", {}}, response, executor);
+    EXPECT_FALSE(response.state->wasSent);
+    EXPECT_EQ(executor.taskCount(), 1u);
+
+    executor.run();
+    EXPECT_EQ(response.state->data, "AB(foo)");
+}
+
+TEST_F(OffloadedProcessors, RouteMatchersCheckedBeforePosting)
+{
+    registerRoutes();
+    auto executor = ManualExecutor{};
+    auto response = Response{};
+    response.init();
+    auto queue = makeRequestProcessorQueue(Request{RequestType::POST, "/foo", {}}, response, executor);
+    queue.launch();
+    // Only the processor registered for the POST requests is posted
+    EXPECT_EQ(executor.taskCount(), 1u);
+    executor.run();
+    EXPECT_EQ(response.state->data, "C");
+}
+
+TEST_F(OffloadedProcessors, StoppedQueueIsntContinuedAfterOffloadedProcessor)
+{
+    registerRoutes();
+    auto executor = ManualExecutor{};
+    auto response = Response{};
+    response.init();
+    auto queue = makeRequestProcessorQueue(Request{RequestType::GET, "/foo", {}}, response, executor);
+    queue.launch();
+    queue.stop();
+    executor.run();
+    EXPECT_FALSE(response.state->wasSent);
+
+    queue.launch();
+    EXPECT_EQ(response.state->data, "AB(foo)");
+}
+
+TEST_F(OffloadedProcessors, ConcurrentProcessing)
+{
+    route(whaleroute::rx{"/(.*)"})
+            .processOffloaded(
+                    [](const std::string& name, const Request&, Response&, Context& context)
+                    {
+                        context.value = ThreadPool::isWorkerThread() ? name : "";
+                    })
+            .process(
+                    [](const Request&, Response& response, const Context& context)
+                    {
+                        response.send(context.value);
+                    });
+    const auto router = freeze();
+    auto threadPool = std::optional<ThreadPool>{4};
+
+    const auto threadCount = 8;
+    const auto requestCount = 200;
+    auto mutex = std::mutex{};
+    auto responses = std::vector<std::pair<std::string, Response>>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+        threads.emplace_back(
+                [&, threadIndex]
+                {
+                    for (auto i = 0; i < requestCount; ++i) {
+                        const auto name = std::to_string(threadIndex * requestCount + i);
+                        auto response = Response{};
+                        response.init();
+                        {
+                            auto lock = std::lock_guard{mutex};
+                            responses.emplace_back(name, response);
+                        }
+                        router.process(Request{RequestType::GET, "/" + name, {}}, response, *threadPool);
+                    }
+                });
+    for (auto& thread : threads)
+        thread.join();
+    threadPool.reset();
+
+    ASSERT_EQ(responses.size(), std::size_t{threadCount * requestCount});
+    auto errorCount = 0;
+    for (const auto& [name, response] : responses)
+        if (response.state->data != name)
+            errorCount++;
+    EXPECT_EQ(errorCount, 0);
+}
@@ -0,0 +1,200 @@
+#include "common.h"
+#include "threadpool.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <thread>
+
+namespace {
+
+struct Context {
+    std::string value;
+};
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+// Stores the posted tasks until run() is called
+class ManualExecutor {
+public:
+    void post(std::function<void()> task)
+    {
+        tasks_.push_back(std::move(task));
+    }
+
+    std::size_t taskCount() const
+    {
+        return tasks_.size();
+    }
+
+    void run()
+    {
+        while (!tasks_.empty()) {
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            task();
+        }
+    }
+
+private:
+    std::deque<std::function<void()>> tasks_;
+};
+
+class TestRouter : public whaleroute::RequestRouter<Request, Response, ResponseSender, Context> {
+public:
+    TestRouter()
+    {
+        for (auto i = 0; i < 500; ++i) {
+            const auto index = std::to_string(i);
+            const auto suffix = std::to_string(i % 10);
+            auto addValue = [index](const std::string& param, const Request&, Response&, Context& context)
+            {
+                context.value += index + "(" + param + ");";
+            };
+            switch (i % 4) {
+            case 0:
+                route("/page/" + suffix)
+                        .process(
+                                [index](const Request&, Response&, Context& context)
+                                {
+                                    context.value += index + ";";
+                                });
+                break;
+            case 1:
+                route(whaleroute::rx{"/page/(" + suffix + ")"}).process(std::move(addValue));
+                break;
+            case 2:
+                route(whaleroute::rx{"/(.*)/" + suffix}).process(std::move(addValue));
+                break;
+            default:
+                route(whaleroute::rx{"/none/(.*)"}).process(std::move(addValue));
+            }
+        }
+        route(whaleroute::rx{".*"})
+                .process(
+                        [](const Request&, Response& response, const Context& context)
+                        {
+                            response.send(context.value);
+                        });
+    }
+
+    template<typename TRouter>
+    static std::string processRequest(TRouter& router, const std::string& path)
+    {
+        auto response = Response{};
+        response.init();
+        router.process(Request{RequestType::GET, path, {}}, response);
+        return response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+class ParallelMatching : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        for (auto i = 0; i < 10; ++i) {
+            requestPaths_.push_back("/page/" + std::to_string(i));
+            requestPaths_.push_back("/foo/" + std::to_string(i));
+        }
+        requestPaths_.push_back("/none/foo");
+        requestPaths_.push_back("/bar");
+        for (const auto& path : requestPaths_)
+            expectedResponses_.push_back(TestRouter::processRequest(serialRouter_, path));
+    }
+
+    template<typename TRouter>
+    std::vector<std::string> processRequests(TRouter& router)
+    {
+        auto result = std::vector<std::string>{};
+        for (const auto& path : requestPaths_)
+            result.push_back(TestRouter::processRequest(router, path));
+        return result;
+    }
+
+    TestRouter serialRouter_;
+    TestRouter router_;
+    std::vector<std::string> requestPaths_;
+    std::vector<std::string> expectedResponses_;
+};
+
+} // namespace
+
+TEST_F(ParallelMatching, MatchesInRegistrationOrder)
+{
+    auto threadPool = ThreadPool{4};
+    router_.enableParallelMatching(threadPool, 8, 10);
+    EXPECT_EQ(processRequests(router_), expectedResponses_);
+
+    auto expectedResponse = std::string{};
+    for (auto i = 0; i < 500; i += 20)
+        expectedResponse += std::to_string(i) + ";" + std::to_string(i + 10) + "(page);";
+    EXPECT_EQ(TestRouter::processRequest(router_, "/page/0"), expectedResponse);
+}
+
+TEST_F(ParallelMatching, CallingThreadMatchesUnprocessedShards)
+{
+    auto executor = ManualExecutor{};
+    router_.enableParallelMatching(executor, 4, 10);
+    EXPECT_EQ(processRequests(router_), expectedResponses_);
+    EXPECT_EQ(executor.taskCount(), 3 * requestPaths_.size());
+    executor.run();
+}
+
+TEST_F(ParallelMatching, SerialMatchingOfSmallTables)
+{
+    auto executor = ManualExecutor{};
+    router_.enableParallelMatching(executor, 4);
+    EXPECT_EQ(processRequests(router_), expectedResponses_);
+    EXPECT_EQ(executor.taskCount(), 0u);
+
+    router_.enableParallelMatching(executor, 4, 10);
+    router_.disableParallelMatching();
+    EXPECT_EQ(processRequests(router_), expectedResponses_);
+    EXPECT_EQ(executor.taskCount(), 0u);
+}
+
+TEST_F(ParallelMatching, ConcurrentProcessingWithFrozenRouter)
+{
+    auto threadPool = ThreadPool{4};
+    router_.enableParallelMatching(threadPool, 4, 10);
+    const auto router = router_.freeze();
+
+    const auto threadCount = 8;
+    const auto requestCount = 20;
+    auto errorCount = std::atomic<int>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+        threads.emplace_back(
+                [&]
+                {
+                    for (auto i = 0; i < requestCount; ++i)
+                        if (processRequests(router) != expectedResponses_)
+                            errorCount++;
+                });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(errorCount, 0);
+}
@@ -0,0 +1,101 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace {
+
+int renderCount = 0;
+int conversionCount = 0;
+
+struct RenderedResponse {
+    std::shared_ptr<const std::string> data;
+};
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        ++conversionCount;
+        response.send(data);
+    }
+
+    void operator()(Response& response, int status, const std::string& data)
+    {
+        ++conversionCount;
+        response.send(std::to_string(status) + " " + data);
+    }
+
+    RenderedResponse render(int status, const std::string& data)
+    {
+        ++renderCount;
+        return {std::make_shared<const std::string>(std::to_string(status) + " " + data)};
+    }
+
+    void operator()(Response& response, const RenderedResponse& renderedResponse)
+    {
+        response.send(*renderedResponse.data);
+    }
+};
+
+class PrerenderedResponses : public ::testing::Test,
+                             public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    std::string processRequest(const std::string& path)
+    {
+        auto response = Response{};
+        response.init();
+        process(Request{RequestType::GET, path, {}}, response);
+        return response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+} // namespace
+
+TEST_F(PrerenderedResponses, RenderedOnceAtRegistration)
+{
+    renderCount = 0;
+    conversionCount = 0;
+    route("/health").set(200, "OK");
+    route("/robots.txt").set(200, std::string{"User-agent: *"});
+    EXPECT_EQ(renderCount, 2);
+
+    for (auto i = 0; i < 3; ++i) {
+        EXPECT_EQ(processRequest("/health"), "200 OK");
+        EXPECT_EQ(processRequest("/robots.txt"), "200 User-agent: *");
+    }
+    EXPECT_EQ(renderCount, 2);
+    EXPECT_EQ(conversionCount, 0);
+}
+
+TEST_F(PrerenderedResponses, ValuesWithoutRenderingAreConverted)
+{
+    renderCount = 0;
+    conversionCount = 0;
+    route("/").set("Hello world");
+    route("/page").process(
+            [](const Request&)
+            {
+                return std::string{"Page"};
+            });
+
+    EXPECT_EQ(processRequest("/"), "Hello world");
+    EXPECT_EQ(processRequest("/page"), "Page");
+    EXPECT_EQ(renderCount, 0);
+    EXPECT_EQ(conversionCount, 2);
+}
@@ -0,0 +1,134 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<int> lookupCount = 0;
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class TestRouter : public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    template<typename TRouter>
+    static std::string processRequest(TRouter& router, const std::string& path)
+    {
+        auto response = Response{};
+        response.init();
+        router.process(Request{RequestType::GET, path, {}}, response);
+        return response.state->data;
+    }
+
+    void onRouteParametersError(const Request&, Response& response, const whaleroute::RouteParameterError&) override
+    {
+        response.send("ROUTE_PARAM_ERROR");
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+std::string lookupUser(int userId, const Request&)
+{
+    ++lookupCount;
+    return "User[" + std::to_string(userId) + "]";
+}
+
+} // namespace
+
+TEST(ResponseCache, ResponsesAreCachedByRouteParameters)
+{
+    auto router = TestRouter{};
+    router.route(whaleroute::rx{R"(/users/(\w+))"}).cache().process(lookupUser);
+    router.route(whaleroute::rx{R"(/items/(\d+))"}).process(lookupUser);
+
+    lookupCount = 0;
+    EXPECT_EQ(TestRouter::processRequest(router, "/users/1"), "User[1]");
+    EXPECT_EQ(TestRouter::processRequest(router, "/users/1"), "User[1]");
+    EXPECT_EQ(TestRouter::processRequest(router, "/users/2"), "User[2]");
+    EXPECT_EQ(lookupCount, 2);
+
+    EXPECT_EQ(TestRouter::processRequest(router, "/users/foo"), "ROUTE_PARAM_ERROR");
+    EXPECT_EQ(TestRouter::processRequest(router, "/users/1"), "User[1]");
+    EXPECT_EQ(lookupCount, 2);
+
+    EXPECT_EQ(TestRouter::processRequest(router, "/items/1"), "User[1]");
+    EXPECT_EQ(TestRouter::processRequest(router, "/items/1"), "User[1]");
+    EXPECT_EQ(lookupCount, 4);
+}
+
+TEST(ResponseCache, LeastRecentlyUsedResponsesAreEvicted)
+{
+    auto router = TestRouter{};
+    router.route(whaleroute::rx{R"(/users/(\d+))"}).cache({2, std::chrono::hours{1}, 1}).process(lookupUser);
+
+    lookupCount = 0;
+    TestRouter::processRequest(router, "/users/1");
+    TestRouter::processRequest(router, "/users/2");
+    TestRouter::processRequest(router, "/users/1");
+    TestRouter::processRequest(router, "/users/3");
+    EXPECT_EQ(lookupCount, 3);
+    TestRouter::processRequest(router, "/users/1");
+    EXPECT_EQ(lookupCount, 3);
+    TestRouter::processRequest(router, "/users/2");
+    EXPECT_EQ(lookupCount, 4);
+}
+
+TEST(ResponseCache, ExpiredResponsesAreRecomputed)
+{
+    auto router = TestRouter{};
+    router.route(whaleroute::rx{R"(/users/(\d+))"}).cache({16, std::chrono::steady_clock::duration::zero()}).process(
+            lookupUser);
+
+    lookupCount = 0;
+    EXPECT_EQ(TestRouter::processRequest(router, "/users/1"), "User[1]");
+    EXPECT_EQ(TestRouter::processRequest(router, "/users/1"), "User[1]");
+    EXPECT_EQ(lookupCount, 2);
+}
+
+TEST(ResponseCache, ConcurrentProcessingWithFrozenRouter)
+{
+    auto router = TestRouter{};
+    router.route(whaleroute::rx{R"(/users/(\d+))"}).cache({64}).process(lookupUser);
+    const auto frozenRouter = router.freeze();
+
+    const auto threadCount = 8;
+    const auto requestCount = 500;
+    auto errorCount = std::atomic<int>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+        threads.emplace_back(
+                [&]
+                {
+                    for (auto i = 0; i < requestCount; ++i) {
+                        const auto userId = std::to_string(i % 100);
+                        if (TestRouter::processRequest(frozenRouter, "/users/" + userId) != "User[" + userId + "]")
+                            errorCount++;
+                    }
+                });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(errorCount, 0);
+}
@@ -0,0 +1,112 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestType> {
+    bool operator()(RequestType value, const Request& request) const
+    {
+        return value == request.type;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class AnalyzingRoutes : public ::testing::Test,
+                        public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+} // namespace
+
+TEST_F(AnalyzingRoutes, EmptyRouteTable)
+{
+    const auto analysis = analyzeRoutes();
+    EXPECT_TRUE(analysis.shadowedRoutes.empty());
+    EXPECT_TRUE(analysis.simplifiableRegexRoutes.empty());
+    EXPECT_TRUE(analysis.duplicateRegexRoutes.empty());
+    EXPECT_EQ(analysis.worstCaseComparisons, 0u);
+}
+
+TEST_F(AnalyzingRoutes, RouteTable)
+{
+    route("/", RequestType::GET).set("GET");
+    route("/").set("Any");
+    route("/").set("Unreachable");
+    route(whaleroute::rx{"/page/.*"}).set("Page");
+    route("/page/1").set("Page 1");
+    route(whaleroute::rx{R"(/page/(\d+))"}).set("Page number");
+    route(whaleroute::rx{R"(/page/(\d+))"}).set("Duplicate page number");
+    route(whaleroute::rx{R"(/about\.html)"});
+    route("/about.html").set("About");
+    route(whaleroute::rx{R"(/about\.html/)"}).set("About");
+    route(whaleroute::rx{R"(/user/([^/]+)/posts)"}).set("Posts");
+
+    const auto analysis = analyzeRoutes();
+    ASSERT_EQ(analysis.shadowedRoutes.size(), 4u);
+    EXPECT_EQ(analysis.shadowedRoutes[0].routeIndex, 2u);
+    EXPECT_EQ(analysis.shadowedRoutes[0].route, "/");
+    EXPECT_EQ(analysis.shadowedRoutes[0].shadowingRouteIndex, 1u);
+    EXPECT_EQ(analysis.shadowedRoutes[0].shadowingRoute, "/");
+    EXPECT_EQ(analysis.shadowedRoutes[1].routeIndex, 4u);
+    EXPECT_EQ(analysis.shadowedRoutes[1].route, "/page/1");
+    EXPECT_EQ(analysis.shadowedRoutes[1].shadowingRouteIndex, 3u);
+    EXPECT_EQ(analysis.shadowedRoutes[1].shadowingRoute, "/page/.*");
+    EXPECT_EQ(analysis.shadowedRoutes[2].routeIndex, 6u);
+    EXPECT_EQ(analysis.shadowedRoutes[2].shadowingRouteIndex, 5u);
+    EXPECT_EQ(analysis.shadowedRoutes[3].routeIndex, 9u);
+    EXPECT_EQ(analysis.shadowedRoutes[3].shadowingRouteIndex, 8u);
+
+    ASSERT_EQ(analysis.simplifiableRegexRoutes.size(), 5u);
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[0].routeIndex, 5u);
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[0].kind, whaleroute::RegexRouteKind::SegmentTemplate);
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[1].routeIndex, 6u);
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[2].routeIndex, 7u);
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[2].pattern, R"(/about\.html)");
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[2].kind, whaleroute::RegexRouteKind::Literal);
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[2].path, "/about.html");
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[3].routeIndex, 9u);
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[3].path, "/about.html/");
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[4].routeIndex, 10u);
+    EXPECT_EQ(analysis.simplifiableRegexRoutes[4].kind, whaleroute::RegexRouteKind::SegmentTemplate);
+
+    ASSERT_EQ(analysis.duplicateRegexRoutes.size(), 1u);
+    EXPECT_EQ(analysis.duplicateRegexRoutes[0].pattern, R"(/page/(\d+))");
+    EXPECT_EQ(analysis.duplicateRegexRoutes[0].routeIndices, (std::vector<std::size_t>{5, 6}));
+
+    EXPECT_EQ(analysis.worstCaseComparisons, 5u);
+}
+
+TEST(RegexSimplification, NotSimplifiable)
+{
+    EXPECT_FALSE(whaleroute::detail::simplifyRegex(".*"));
+    EXPECT_FALSE(whaleroute::detail::simplifyRegex("/page/(.*)"));
+    EXPECT_FALSE(whaleroute::detail::simplifyRegex(R"(/page/(\d+)-(\d+))"));
+    EXPECT_FALSE(whaleroute::detail::simplifyRegex(R"(/page/(\d+)/?)"));
+    EXPECT_FALSE(whaleroute::detail::simplifyRegex(R"(/page/\d+)"));
+    EXPECT_FALSE(whaleroute::detail::simplifyRegex("/foo|/bar"));
+    EXPECT_FALSE(whaleroute::detail::simplifyRegex("/page/[a-z]"));
+}
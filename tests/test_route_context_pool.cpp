@@ -0,0 +1,171 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<int> contextCount = 0;
+std::atomic<int> resetCount = 0;
+
+struct Context {
+    Context()
+    {
+        ++contextCount;
+    }
+    Context(Context&&) = default;
+    Context& operator=(Context&&) = default;
+
+    std::vector<std::string> log;
+};
+
+struct ContextWithoutReset {
+    std::vector<std::string> log;
+};
+
+} // namespace
+
+namespace whaleroute::config {
+template<>
+struct RouteContextReset<Context> {
+    void operator()(Context& context) const
+    {
+        ++resetCount;
+        context.log.clear();
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+template<typename TRouteContext>
+class TestRouter : public whaleroute::RequestRouter<Request, Response, ResponseSender, TRouteContext> {
+public:
+    TestRouter()
+    {
+        this->route(whaleroute::rx{".*"})
+                .process(
+                        [](const Request& request, Response&, TRouteContext& context)
+                        {
+                            context.log.push_back(request.requestPath);
+                        });
+        this->route("/log").process(
+                [](const Request&, Response& response, const TRouteContext& context)
+                {
+                    auto result = std::string{};
+                    for (const auto& entry : context.log)
+                        result += entry + ";";
+                    response.send(result + std::to_string(context.log.capacity()));
+                });
+    }
+
+    template<typename TRouter>
+    static std::string processRequest(TRouter& router, const std::string& path)
+    {
+        auto response = Response{};
+        response.init();
+        router.process(Request{RequestType::GET, path, {}}, response);
+        return response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+} // namespace
+
+TEST(RouteContextPool, ContextsAreResetAndReused)
+{
+    auto router = TestRouter<Context>{};
+    router.enableRouteContextPool();
+    contextCount = 0;
+    resetCount = 0;
+
+    EXPECT_EQ(TestRouter<Context>::processRequest(router, "/log"), "/log;1");
+    EXPECT_EQ(TestRouter<Context>::processRequest(router, "/log"), "/log;1");
+    EXPECT_EQ(TestRouter<Context>::processRequest(router, "/foo"), "");
+    EXPECT_EQ(contextCount, 1);
+    EXPECT_EQ(resetCount, 3);
+
+    router.disableRouteContextPool();
+    EXPECT_EQ(TestRouter<Context>::processRequest(router, "/log"), "/log;1");
+    EXPECT_EQ(contextCount, 2);
+    EXPECT_EQ(resetCount, 3);
+}
+
+TEST(RouteContextPool, MaxSizePerThread)
+{
+    auto router = TestRouter<Context>{};
+    router.enableRouteContextPool(1);
+    contextCount = 0;
+
+    auto makeQueues = [&]
+    {
+        auto result = std::vector<whaleroute::RequestProcessorQueue>{};
+        for (auto i = 0; i < 3; ++i) {
+            auto response = Response{};
+            response.init();
+            result.push_back(router.makeRequestProcessorQueue(Request{RequestType::GET, "/log", {}}, response));
+        }
+        return result;
+    };
+    makeQueues();
+    EXPECT_EQ(contextCount, 3);
+    makeQueues();
+    EXPECT_EQ(contextCount, 5);
+}
+
+TEST(RouteContextPool, ContextsWithoutResetAreReassigned)
+{
+    auto router = TestRouter<ContextWithoutReset>{};
+    router.enableRouteContextPool();
+
+    EXPECT_EQ(TestRouter<ContextWithoutReset>::processRequest(router, "/log"), "/log;1");
+    EXPECT_EQ(TestRouter<ContextWithoutReset>::processRequest(router, "/log"), "/log;1");
+}
+
+TEST(RouteContextPool, ConcurrentProcessingWithFrozenRouter)
+{
+    auto router = TestRouter<Context>{};
+    router.enableRouteContextPool(4);
+    const auto frozenRouter = router.freeze();
+
+    const auto threadCount = 8;
+    const auto requestCount = 500;
+    auto errorCount = std::atomic<int>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+        threads.emplace_back(
+                [&]
+                {
+                    for (auto i = 0; i < requestCount; ++i)
+                        if (TestRouter<Context>::processRequest(frozenRouter, "/log") != "/log;1")
+                            errorCount++;
+                });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(errorCount, 0);
+}
@@ -0,0 +1,175 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+
+namespace {
+int nameCheckCount = 0;
+
+struct RequestName {
+    std::string value;
+};
+} // namespace
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestType> {
+    bool operator()(RequestType value, const Request& request) const
+    {
+        return value == request.type;
+    }
+};
+
+template<>
+struct RouteMatcher<RequestName> {
+    bool operator()(const RequestName& name, const Request& request) const
+    {
+        ++nameCheckCount;
+        return name.value == request.name;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class TestRouter : public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    std::string processRequest(
+            const std::string& path,
+            RequestType requestType = RequestType::GET,
+            const std::string& name = {})
+    {
+        auto response = Response{};
+        response.init();
+        process(Request{requestType, path, name}, response);
+        return response.state->context + response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+auto addContext(const std::string& value)
+{
+    return [value](const Request&, Response& response)
+    {
+        response.state->context += value + ";";
+    };
+}
+
+} // namespace
+
+TEST(RouteGroups, GroupRoutes)
+{
+    auto router = TestRouter{};
+    auto& api = router.group("/api/v2/");
+    api.route("/").set("Api");
+    api.route("/users", RequestType::GET).set("Users");
+    api.route("/users", RequestType::POST).set("New user");
+    api.route(whaleroute::rx{R"(/users/(\d+))"})
+            .process(
+                    [](int userId, const Request&)
+                    {
+                        return "User[" + std::to_string(userId) + "]";
+                    });
+    auto& admin = api.group("/admin");
+    admin.route("/stats").set("Stats");
+    admin.route(whaleroute::rx{"/logs/(.+)/"})
+            .process(
+                    [](const std::string& logName, const Request&)
+                    {
+                        return "Log[" + logName + "]";
+                    });
+    router.route("/users").set("Old users");
+    router.route(whaleroute::rx{".*"}).set("Fallback");
+
+    EXPECT_EQ(router.processRequest("/api/v2"), "Api");
+    EXPECT_EQ(router.processRequest("/api/v2/"), "Api");
+    EXPECT_EQ(router.processRequest("/api/v2/users"), "Users");
+    EXPECT_EQ(router.processRequest("/api/v2/users", RequestType::POST), "New user");
+    EXPECT_EQ(router.processRequest("/api/v2/users/42"), "User[42]");
+    EXPECT_EQ(router.processRequest("/api/v2/admin/stats/"), "Stats");
+    EXPECT_EQ(router.processRequest("/api/v2/admin/logs/errors"), "Log[errors]");
+    EXPECT_EQ(router.processRequest("/users"), "Old users");
+    EXPECT_EQ(router.processRequest("/users/42"), "Fallback");
+    EXPECT_EQ(router.processRequest("/api/v1/users/42"), "Fallback");
+    EXPECT_EQ(router.processRequest("/admin/stats"), "Fallback");
+}
+
+TEST(RouteGroups, GroupMatchersAreCheckedOncePerRequest)
+{
+    auto router = TestRouter{};
+    auto& group = router.group("/api", RequestName{"admin"});
+    group.route(whaleroute::rx{"/.*"}).process(addContext("log"));
+    group.route(whaleroute::rx{"/users/.*"}).process(addContext("auth")).process(addContext("check"));
+    group.route("/users/1", RequestType::GET).set("User");
+    router.route(whaleroute::rx{".*"}).set("Fallback");
+
+    nameCheckCount = 0;
+    EXPECT_EQ(router.processRequest("/api/users/1", RequestType::GET, "admin"), "log;auth;check;User");
+    EXPECT_EQ(nameCheckCount, 1);
+
+    nameCheckCount = 0;
+    EXPECT_EQ(router.processRequest("/api/users/1", RequestType::GET, "guest"), "Fallback");
+    EXPECT_EQ(nameCheckCount, 1);
+
+    nameCheckCount = 0;
+    EXPECT_EQ(router.processRequest("/users/1", RequestType::GET, "admin"), "Fallback");
+    EXPECT_EQ(nameCheckCount, 0);
+}
+
+TEST(RouteGroups, RegexAlternativesDontSkipPrefix)
+{
+    auto router = TestRouter{};
+    router.setTrailingSlashMode(whaleroute::TrailingSlashMode::Strict);
+    auto& group = router.group("/api.v2");
+    group.route(whaleroute::rx{"/a|/b/"}).set("Api");
+
+    EXPECT_EQ(router.processRequest("/api.v2/a"), "Api");
+    EXPECT_EQ(router.processRequest("/api.v2/b/"), "Api");
+    EXPECT_EQ(router.processRequest("/api.v2/b"), "NO_MATCH");
+    EXPECT_EQ(router.processRequest("/b/"), "NO_MATCH");
+    EXPECT_EQ(router.processRequest("/apixv2/a"), "NO_MATCH");
+}
+
+TEST(RouteGroups, FrozenRouter)
+{
+    auto router = TestRouter{};
+    auto& group = router.group("/api", RequestName{"admin"});
+    group.route(whaleroute::rx{"/(.*)"}).process(addContext("log"));
+    group.route("/users").set("Users");
+    router.route(whaleroute::rx{".*"}).set("Fallback");
+    const auto frozenRouter = router.freeze();
+
+    auto processRequest = [&](const std::string& path, const std::string& name)
+    {
+        auto response = Response{};
+        response.init();
+        frozenRouter.process(Request{RequestType::GET, path, name}, response);
+        return response.state->context + response.state->data;
+    };
+    nameCheckCount = 0;
+    EXPECT_EQ(processRequest("/api/users", "admin"), "log;Users");
+    EXPECT_EQ(nameCheckCount, 1);
+    EXPECT_EQ(processRequest("/api/users", "guest"), "Fallback");
+    EXPECT_EQ(processRequest("/users", "admin"), "Fallback");
+}
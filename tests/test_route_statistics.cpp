@@ -0,0 +1,215 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class CollectingRouteStatistics : public ::testing::Test,
+                                  public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    template<typename TRouter>
+    static std::string processRequest(TRouter& router, const std::string& path)
+    {
+        auto response = Response{};
+        response.init();
+        router.process(Request{RequestType::GET, path, {}}, response);
+        return response.state->data;
+    }
+
+    void onRouteParametersError(const Request&, Response& response, const whaleroute::RouteParameterError& error)
+            override
+    {
+        response.send(getRouteParamErrorInfo(error));
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+
+    void registerRoutes()
+    {
+        route("/")
+                .process(
+                        [](const Request&, Response&)
+                        {
+                            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                        })
+                .set("Hello world");
+        route(whaleroute::rx{R"(/page/(\d+|foo))"})
+                .process(
+                        [](int pageIndex, const Request&)
+                        {
+                            return "Page[" + std::to_string(pageIndex) + "]";
+                        });
+    }
+};
+
+} // namespace
+
+TEST_F(CollectingRouteStatistics, DisabledByDefault)
+{
+    registerRoutes();
+    EXPECT_EQ(processRequest(*this, "/"), "Hello world");
+    EXPECT_TRUE(routeStatistics().empty());
+}
+
+TEST_F(CollectingRouteStatistics, Counters)
+{
+    registerRoutes();
+    enableRouteStatistics();
+    route("/bar").set("Bar");
+
+    EXPECT_EQ(processRequest(*this, "/"), "Hello world");
+    EXPECT_EQ(processRequest(*this, "/"), "Hello world");
+    EXPECT_EQ(processRequest(*this, "/page/1"), "Page[1]");
+    EXPECT_EQ(processRequest(*this, "/page/foo"), "ROUTE_PARAM_ERROR: COULDN'T READ ROUTE PARAM, INDEX:1 VALUE:foo");
+    EXPECT_EQ(processRequest(*this, "/foo"), "NO_MATCH");
+
+    const auto statistics = routeStatistics();
+    ASSERT_EQ(statistics.size(), 3u);
+    EXPECT_EQ(statistics[0].routeIndex, 0u);
+    EXPECT_EQ(statistics[0].route, "/");
+    EXPECT_EQ(statistics[0].matchCount, 2u);
+    EXPECT_EQ(statistics[0].invocationCount, 4u);
+    EXPECT_EQ(statistics[0].routeParameterErrorCount, 0u);
+    EXPECT_GE(statistics[0].processingTime, std::chrono::milliseconds{2});
+
+    EXPECT_EQ(statistics[1].routeIndex, 1u);
+    EXPECT_EQ(statistics[1].route, R"(/page/(\d+|foo))");
+    EXPECT_EQ(statistics[1].matchCount, 2u);
+    EXPECT_EQ(statistics[1].invocationCount, 2u);
+    EXPECT_EQ(statistics[1].routeParameterErrorCount, 1u);
+
+    EXPECT_EQ(statistics[2].routeIndex, 2u);
+    EXPECT_EQ(statistics[2].route, "/bar");
+    EXPECT_EQ(statistics[2].matchCount, 0u);
+    EXPECT_EQ(statistics[2].invocationCount, 0u);
+}
+
+TEST_F(CollectingRouteStatistics, ConcurrentProcessingWithFrozenRouter)
+{
+    enableRouteStatistics(whaleroute::RouteStatisticsLevel::LatencyHistograms);
+    route("/").set("Hello world");
+    route(whaleroute::rx{R"(/page/(\d+))"}).set("Page");
+    const auto router = freeze();
+
+    const auto threadCount = 8;
+    const auto requestCount = 500;
+    auto threads = std::vector<std::thread>{};
+    for (auto threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+        threads.emplace_back(
+                [&]
+                {
+                    for (auto i = 0; i < requestCount; ++i) {
+                        processRequest(router, "/");
+                        processRequest(router, "/page/" + std::to_string(i));
+                    }
+                });
+    for (auto& thread : threads)
+        thread.join();
+
+    const auto statistics = routeStatistics();
+    ASSERT_EQ(statistics.size(), 2u);
+    EXPECT_EQ(statistics[0].matchCount, std::uint64_t{threadCount * requestCount});
+    EXPECT_EQ(statistics[0].invocationCount, std::uint64_t{threadCount * requestCount});
+    EXPECT_EQ(statistics[1].matchCount, std::uint64_t{threadCount * requestCount});
+    EXPECT_EQ(statistics[1].invocationCount, std::uint64_t{threadCount * requestCount});
+    EXPECT_EQ(statistics[1].latency.count(), std::uint64_t{threadCount * requestCount});
+    EXPECT_EQ(routingLatency().count(), std::uint64_t{2 * threadCount * requestCount});
+}
+
+TEST_F(CollectingRouteStatistics, LatencyHistogramsDisabledByDefault)
+{
+    registerRoutes();
+    enableRouteStatistics();
+    EXPECT_EQ(processRequest(*this, "/"), "Hello world");
+
+    const auto statistics = routeStatistics();
+    ASSERT_EQ(statistics.size(), 2u);
+    EXPECT_EQ(statistics[0].invocationCount, 2u);
+    EXPECT_EQ(statistics[0].latency.count(), 0u);
+    EXPECT_TRUE(statistics[0].processorLatencies.empty());
+    EXPECT_EQ(routingLatency().count(), 0u);
+}
+
+TEST_F(CollectingRouteStatistics, LatencyHistograms)
+{
+    registerRoutes();
+    enableRouteStatistics(whaleroute::RouteStatisticsLevel::LatencyHistograms);
+    route("/bar")
+            .process(
+                    [](const Request&)
+                    {
+                        return "Bar";
+                    })
+            .set("Baz");
+    for (auto i = 0; i < 10; ++i)
+        EXPECT_EQ(processRequest(*this, "/"), "Hello world");
+    EXPECT_EQ(processRequest(*this, "/bar"), "Baz");
+    EXPECT_EQ(processRequest(*this, "/foo"), "NO_MATCH");
+
+    const auto statistics = routeStatistics();
+    ASSERT_EQ(statistics.size(), 3u);
+    EXPECT_EQ(statistics[0].latency.count(), 10u);
+    EXPECT_GE(statistics[0].latency.percentile(50), std::chrono::milliseconds{1});
+    ASSERT_EQ(statistics[0].processorLatencies.size(), 2u);
+    EXPECT_EQ(statistics[0].processorLatencies[0].count(), 10u);
+    EXPECT_GE(statistics[0].processorLatencies[0].percentile(50), std::chrono::milliseconds{1});
+    EXPECT_EQ(statistics[0].processorLatencies[1].count(), 10u);
+    EXPECT_LT(statistics[0].processorLatencies[1].percentile(50), std::chrono::milliseconds{1});
+
+    EXPECT_EQ(statistics[1].latency.count(), 0u);
+    ASSERT_EQ(statistics[1].processorLatencies.size(), 1u);
+
+    EXPECT_EQ(statistics[2].latency.count(), 1u);
+    ASSERT_EQ(statistics[2].processorLatencies.size(), 2u);
+    EXPECT_EQ(statistics[2].processorLatencies[0].count(), 1u);
+    EXPECT_EQ(statistics[2].processorLatencies[1].count(), 1u);
+
+    EXPECT_EQ(routingLatency().count(), 12u);
+}
+
+TEST(LatencyHistogram, Percentiles)
+{
+    auto recorder = whaleroute::detail::LatencyRecorder{};
+    auto otherRecorder = whaleroute::detail::LatencyRecorder{};
+    for (auto i = 1; i <= 1000; ++i) {
+        recorder.record(std::chrono::microseconds{i});
+        otherRecorder.record(std::chrono::microseconds{i});
+    }
+    auto histogram = recorder.histogram();
+    histogram.merge(otherRecorder.histogram());
+    EXPECT_EQ(histogram.count(), 2000u);
+
+    auto expectNear = [](std::chrono::nanoseconds value, std::chrono::microseconds expectedValue)
+    {
+        EXPECT_GE(value, expectedValue);
+        EXPECT_LE(value.count(), expectedValue.count() * 1000 * 103 / 100);
+    };
+    expectNear(histogram.percentile(50), std::chrono::microseconds{500});
+    expectNear(histogram.percentile(99), std::chrono::microseconds{990});
+    expectNear(histogram.percentile(99.9), std::chrono::microseconds{999});
+    expectNear(histogram.percentile(100), std::chrono::microseconds{1000});
+    EXPECT_EQ(whaleroute::LatencyHistogram{}.percentile(99), std::chrono::nanoseconds{});
+}
@@ -0,0 +1,115 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+
+namespace whaleroute::config {
+template<>
+struct RouteMatcher<RequestType> {
+    bool operator()(RequestType value, const Request& request) const
+    {
+        return value == request.type;
+    }
+};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class TestRouter : public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+public:
+    std::string processRequest(const std::string& path, RequestType requestType = RequestType::GET)
+    {
+        auto response = Response{};
+        response.init();
+        process(Request{requestType, path, {}}, response);
+        return response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const Request&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+std::string makeSnapshot()
+{
+    auto router = TestRouter{};
+    router.setTrailingSlashMode(whaleroute::TrailingSlashMode::Strict);
+    router.route("/", RequestType::GET).set("Hello world");
+    router.route(whaleroute::rx{R"(/page/(\d+))"}).set("Page");
+    router.route("/about/").set("About");
+    return router.saveRouteTable();
+}
+
+} // namespace
+
+TEST(RouteTableSnapshot, LoadRoutes)
+{
+    auto router = TestRouter{};
+    ASSERT_TRUE(router.loadRouteTable(makeSnapshot()));
+    router.routeById(0, RequestType::GET).set("Hello world");
+    router.routeById(1)
+            .process(
+                    [](int pageIndex, const Request&)
+                    {
+                        return "Page[" + std::to_string(pageIndex) + "]";
+                    });
+    router.routeById(2).set("About");
+
+    EXPECT_EQ(router.processRequest("/"), "Hello world");
+    EXPECT_EQ(router.processRequest("/", RequestType::POST), "");
+    EXPECT_EQ(router.processRequest("/page/42"), "Page[42]");
+    EXPECT_EQ(router.processRequest("/about/"), "About");
+    EXPECT_EQ(router.processRequest("/about"), "NO_MATCH");
+    EXPECT_THROW(router.routeById(3), std::out_of_range);
+}
+
+TEST(RouteTableSnapshot, SaveLoadedRoutes)
+{
+    const auto snapshot = makeSnapshot();
+    auto router = TestRouter{};
+    ASSERT_TRUE(router.loadRouteTable(snapshot));
+    EXPECT_EQ(router.saveRouteTable(), snapshot);
+}
+
+TEST(RouteTableSnapshot, EmptyRouteTable)
+{
+    auto router = TestRouter{};
+    ASSERT_TRUE(router.loadRouteTable(TestRouter{}.saveRouteTable()));
+    EXPECT_EQ(router.processRequest("/"), "NO_MATCH");
+}
+
+TEST(RouteTableSnapshot, InvalidData)
+{
+    const auto snapshot = makeSnapshot();
+    auto router = TestRouter{};
+    EXPECT_FALSE(router.loadRouteTable(""));
+    EXPECT_FALSE(router.loadRouteTable("Hello world"));
+    EXPECT_FALSE(router.loadRouteTable(snapshot.substr(0, snapshot.size() - 1)));
+    EXPECT_FALSE(router.loadRouteTable(snapshot + "/"));
+    auto corruptedSnapshot = snapshot;
+    corruptedSnapshot[4] = 42;
+    EXPECT_FALSE(router.loadRouteTable(corruptedSnapshot));
+
+    router.route("/").set("Hello world");
+    EXPECT_FALSE(router.loadRouteTable(snapshot));
+    EXPECT_EQ(router.processRequest("/"), "Hello world");
+    EXPECT_EQ(router.processRequest("/page/1"), "NO_MATCH");
+}
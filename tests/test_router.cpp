@@ -441,4 +441,19 @@ TEST_F(Router, SameParametrizedProcessorTypeCreatedInMultipleRoutes)
     processRequest("/test2/bar");
     checkResponse("TEST bar");
     ASSERT_EQ(state, 1); // Which means that routes contain different processor objects
-}
\ No newline at end of file
+}
+TEST_F(Router, SameProcessorTypeCreatedPerThread)
+{
+    int state = 0;
+    route("/test", RequestType::GET).processPerThread<CounterRouteProcessor>(std::ref(state));
+    route("/test2", RequestType::GET).processPerThread<CounterRouteProcessor>(std::ref(state));
+
+    processRequest("/test");
+    checkResponse("TEST");
+    processRequest("/test");
+    checkResponse("TEST");
+    ASSERT_EQ(state, 2); // Which means that the same processor object is used by the thread
+    processRequest("/test2");
+    checkResponse("TEST");
+    ASSERT_EQ(state, 1); // Which means that routes contain different processor objects
+}
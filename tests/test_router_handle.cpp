@@ -0,0 +1,113 @@
+#include "common.h"
+#include <whaleroute/requestrouterhandle.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+class Router : public whaleroute::RequestRouter<Request, Response, ResponseSender> {
+    std::string getRequestPath(const Request& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const Request&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+};
+
+using RouterHandle = whaleroute::RequestRouterHandle<Request, Response, ResponseSender>;
+
+std::shared_ptr<Router> makeRouter(const std::string& greeting)
+{
+    auto router = std::make_shared<Router>();
+    router->route("/").set(greeting);
+    router->route("/" + greeting).set(greeting);
+    return router;
+}
+
+std::string processRequest(const RouterHandle& router, const std::string& path)
+{
+    auto response = Response{};
+    response.init();
+    router.process(Request{RequestType::GET, path, {}}, response);
+    return response.state->data;
+}
+
+} // namespace
+
+TEST(RequestRouterHandle, Publish)
+{
+    auto router = RouterHandle{makeRouter("Hello")};
+    EXPECT_EQ(processRequest(router, "/"), "Hello");
+    EXPECT_EQ(processRequest(router, "/Hello"), "Hello");
+
+    router.publish(makeRouter("Hi"));
+    EXPECT_EQ(processRequest(router, "/"), "Hi");
+    EXPECT_EQ(processRequest(router, "/Hello"), "NO_MATCH");
+    EXPECT_EQ(processRequest(router, "/Hi"), "Hi");
+
+    auto frozenRouter = Router{};
+    frozenRouter.route("/").set("Hey");
+    router.publish(frozenRouter.freeze());
+    EXPECT_EQ(processRequest(router, "/"), "Hey");
+}
+
+TEST(RequestRouterHandle, InFlightQueueKeepsPreviousRoutes)
+{
+    auto oldRouter = makeRouter("Hello");
+    auto oldRouterObserver = std::weak_ptr<Router>{oldRouter};
+    auto router = RouterHandle{std::move(oldRouter)};
+
+    auto response = Response{};
+    response.init();
+    auto queue = router.makeRequestProcessorQueue(Request{RequestType::GET, "/", {}}, response);
+
+    router.publish(makeRouter("Hi"));
+    EXPECT_FALSE(oldRouterObserver.expired());
+
+    queue.launch();
+    EXPECT_EQ(response.state->data, "Hello");
+    EXPECT_EQ(processRequest(router, "/"), "Hi");
+
+    queue = {};
+    EXPECT_TRUE(oldRouterObserver.expired());
+}
+
+TEST(RequestRouterHandle, ConcurrentPublishing)
+{
+    auto router = RouterHandle{makeRouter("0")};
+    auto isPublishing = std::atomic<bool>{true};
+    auto errorCount = std::atomic<int>{};
+
+    auto threads = std::vector<std::thread>{};
+    for (auto i = 0; i < 8; ++i)
+        threads.emplace_back(
+                [&]
+                {
+                    while (isPublishing) {
+                        const auto greeting = processRequest(router, "/");
+                        if (processRequest(router, "/" + greeting) == "NO_MATCH" &&
+                            processRequest(router, "/") == greeting)
+                            errorCount++;
+                    }
+                });
+
+    for (auto i = 1; i <= 200; ++i)
+        router.publish(makeRouter(std::to_string(i)));
+    isPublishing = false;
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(errorCount, 0);
+    EXPECT_EQ(processRequest(router, "/"), "200");
+}
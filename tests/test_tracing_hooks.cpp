@@ -0,0 +1,160 @@
+#include "common.h"
+#include <whaleroute/requestrouter.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TracedRequest {
+    std::string requestPath;
+};
+
+struct UntracedRequest {
+    std::string requestPath;
+};
+
+std::vector<std::string> traceLog;
+
+} // namespace
+
+namespace whaleroute::config {
+template<>
+struct RouteTracer<TracedRequest> {
+    void onRouteMatched(const TracedRequest& request, std::size_t routeId)
+    {
+        traceLog.push_back(request.requestPath + " matched:" + std::to_string(routeId));
+    }
+
+    void onProcessorStarted(const TracedRequest&, std::size_t routeId, std::size_t processorIndex)
+    {
+        traceLog.push_back("start:" + std::to_string(routeId) + "/" + std::to_string(processorIndex));
+    }
+
+    void onProcessorFinished(const TracedRequest&, std::size_t routeId, std::size_t processorIndex)
+    {
+        traceLog.push_back("end:" + std::to_string(routeId) + "/" + std::to_string(processorIndex));
+    }
+
+    void onRequestUnmatched(const TracedRequest& request)
+    {
+        traceLog.push_back(request.requestPath + " unmatched");
+    }
+};
+
+template<>
+struct RouteTracer<UntracedRequest> {};
+} // namespace whaleroute::config
+
+namespace {
+
+struct ResponseSender {
+    void operator()(Response& response, const std::string& data)
+    {
+        response.send(data);
+    }
+};
+
+template<typename TRequest>
+class TestRouter : public whaleroute::RequestRouter<TRequest, Response, ResponseSender> {
+public:
+    template<typename TRouter>
+    static std::string processRequest(TRouter& router, const std::string& path)
+    {
+        auto response = Response{};
+        response.init();
+        router.process(TRequest{path}, response);
+        return response.state->data;
+    }
+
+protected:
+    std::string getRequestPath(const TRequest& request) final
+    {
+        return request.requestPath;
+    }
+
+    void processUnmatchedRequest(const TRequest&, Response& response) final
+    {
+        response.send("NO_MATCH");
+    }
+
+    bool isRouteProcessingFinished(const TRequest&, Response& response) const final
+    {
+        return response.state->wasSent;
+    }
+};
+
+class TracingHooks : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        traceLog.clear();
+        router_.route("/")
+                .process(
+                        [](const TracedRequest&, Response& response)
+                        {
+                            response.state->context = "Hello";
+                        })
+                .set("Hello world");
+        router_.route(whaleroute::rx{R"(/page/(\d+))"})
+                .process(
+                        [](int pageIndex, const TracedRequest&)
+                        {
+                            return "Page[" + std::to_string(pageIndex) + "]";
+                        });
+        router_.route(whaleroute::rx{"/.*"})
+                .process(
+                        [](const TracedRequest&, Response& response)
+                        {
+                            response.send("Any");
+                        });
+    }
+
+    TestRouter<TracedRequest> router_;
+};
+
+} // namespace
+
+TEST_F(TracingHooks, MatchedRoutes)
+{
+    EXPECT_EQ(TestRouter<TracedRequest>::processRequest(router_, "/"), "Hello world");
+    EXPECT_EQ(
+            traceLog,
+            (std::vector<std::string>{"/ matched:0", "start:0/0", "end:0/0", "start:0/1", "end:0/1"}));
+
+    traceLog.clear();
+    EXPECT_EQ(TestRouter<TracedRequest>::processRequest(router_, "/page/42"), "Page[42]");
+    EXPECT_EQ(
+            traceLog,
+            (std::vector<std::string>{"/page/42 matched:1", "start:1/0", "end:1/0"}));
+}
+
+TEST_F(TracingHooks, UnmatchedRequest)
+{
+    EXPECT_EQ(TestRouter<TracedRequest>::processRequest(router_, "foo"), "NO_MATCH");
+    EXPECT_EQ(traceLog, (std::vector<std::string>{"foo unmatched"}));
+}
+
+TEST_F(TracingHooks, FrozenRouter)
+{
+    const auto router = router_.freeze();
+    EXPECT_EQ(TestRouter<TracedRequest>::processRequest(router, "/page/1"), "Page[1]");
+    EXPECT_EQ(TestRouter<TracedRequest>::processRequest(router, "foo"), "NO_MATCH");
+    EXPECT_EQ(
+            traceLog,
+            (std::vector<std::string>{
+                    "/page/1 matched:1",
+                    "start:1/0",
+                    "end:1/0",
+                    "foo unmatched"}));
+}
+
+TEST(TracingHooksNotImplemented, RouterWithoutHooks)
+{
+    traceLog.clear();
+    auto router = TestRouter<UntracedRequest>{};
+    router.route("/").set("Hello world");
+    EXPECT_EQ(TestRouter<UntracedRequest>::processRequest(router, "/"), "Hello world");
+    EXPECT_EQ(TestRouter<UntracedRequest>::processRequest(router, "foo"), "NO_MATCH");
+    EXPECT_TRUE(traceLog.empty());
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount)
+    {
+        for (auto i = 0; i < threadCount; ++i)
+            threads_.emplace_back(
+                    [this]
+                    {
+                        work();
+                    });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            auto lock = std::lock_guard{mutex_};
+            isStopped_ = true;
+        }
+        taskAdded_.notify_all();
+        for (auto& thread : threads_)
+            thread.join();
+    }
+
+    static bool isWorkerThread()
+    {
+        return isWorkerThread_;
+    }
+
+    void post(std::function<void()> task)
+    {
+        {
+            auto lock = std::lock_guard{mutex_};
+            tasks_.push_back(std::move(task));
+        }
+        taskAdded_.notify_one();
+    }
+
+private:
+    void work()
+    {
+        isWorkerThread_ = true;
+        while (true) {
+            auto lock = std::unique_lock{mutex_};
+            taskAdded_.wait(
+                    lock,
+                    [this]
+                    {
+                        return isStopped_ || !tasks_.empty();
+                    });
+            if (tasks_.empty())
+                return;
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+        }
+    }
+
+private:
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable taskAdded_;
+    bool isStopped_ = false;
+    static inline thread_local bool isWorkerThread_ = false;
+};